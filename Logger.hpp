@@ -9,6 +9,26 @@
  * - Console and file output
  * - File rotation with configurable size and count
  * - Asynchronous logging support
+ * - Priority lane so ERROR/FATAL records bypass queued backlog
+ * - Opt-in crash handler that drains the async queue on fatal signals
+ * - Lock-free MPSC async queue engine
+ * - Sharded async queues with configurable backend workers
+ * - NUMA mode with a node-local queue and pinned worker per node
+ * - Byte-bounded async queue for a hard memory cap
+ * - Adaptive mode returning queue memory to the OS after bursts
+ * - Optional huge-page backed queue memory
+ * - Per-thread slab allocator for queued payloads
+ * - Queue capacity auto-tuning from observed bursts
+ * - Manual pump mode for event loops (poll() + eventfd, no worker threads)
+ * - io_uring file writer with registered buffers
+ * - Memory-mapped append file writer with preallocated segments
+ * - Page-cache friendly file writers (O_DIRECT or fadvise DONTNEED)
+ * - Asynchronous rotation into a pre-opened file
+ * - Sequential rotated-file naming with O(1) rotations
+ * - Background gzip of rotated files and a streaming gzip file writer
+ * - Hourly/daily rotation with a total-size retention cap
+ * - Durability policies (flush, fdatasync) with group commit
+ * - Buffered, colorless console output for non-TTY stdout
  * - Custom log patterns
  * - Memory-efficient design
  */
@@ -18,9 +38,12 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/rotating_file_sink.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/async.h>
 #include <memory>
 #include <vector>
+#include <deque>
+#include <tuple>
 #include <string>
 #include <iostream>
 #include <filesystem>
@@ -30,15 +53,88 @@
 #include <stdexcept> // For std::runtime_error
 #include <exception> // For std::exception
 #include <cstdint> // For uintptr_t
+#include <cstring> // For std::memcpy
+#include <cstddef> // For std::ptrdiff_t
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <future>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <new> // For placement new
+#include <utility> // For std::exchange
+#include <csignal>
+#include <cerrno>
+#include <ctime>
+#include <cctype>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h> // For malloc_trim
+#endif
+#ifdef FRESHLOGGER_WITH_ZLIB
+#include <zlib.h> // compressRotated and FileBackend::GZIP; define the macro and link zlib to enable them
+#endif
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(__NR_io_uring_setup)
+#define FRESHLOGGER_HAS_IO_URING 1
+#endif
+#endif
 
 // Constants for magic numbers
 namespace LoggerConstants {
     constexpr size_t DEFAULT_MAX_FILE_SIZE = 10 * 1024 * 1024; // 10MB
     constexpr int DEFAULT_MAX_FILES = 5;
     constexpr size_t DEFAULT_QUEUE_SIZE = 8192;
+    constexpr size_t DEFAULT_PRIORITY_QUEUE_SIZE = 1024;
+    constexpr size_t CRASH_BUFFER_SIZE = 64 * 1024;
+    constexpr size_t MAX_CRASH_ENGINES = 32;
+    constexpr int CRASH_PARK_TIMEOUT_MS = 2000;
+    constexpr int DEFAULT_SHUTDOWN_DEADLINE_MS = 5000;
+    constexpr size_t CACHE_LINE_SIZE = 64;
+    constexpr size_t POSTING_SLOTS = 64; // Per-engine in-flight producer counters, one cache line each
+    constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024; // x86-64 and arm64 default huge page
+    constexpr size_t INLINE_RECORD_SIZE = 250; // spdlog::memory_buf_t inline capacity
     constexpr size_t DEFAULT_FLUSH_INTERVAL = 3;
     constexpr size_t KILOBYTE = 1024;
     constexpr size_t MEGABYTE = KILOBYTE * KILOBYTE;
+    constexpr size_t DEFAULT_QUEUE_BYTES = 8 * MEGABYTE;
+    constexpr size_t MIN_QUEUE_BYTES = 4 * KILOBYTE;
+    constexpr size_t PRIORITY_QUEUE_BYTES_DIVISOR = 16; // Byte-ring priority lane is queueBytes / 16
+    constexpr size_t DEFAULT_AUTO_TUNE_MIN_QUEUE_SIZE = 1024;
+    constexpr size_t DEFAULT_AUTO_TUNE_MAX_QUEUE_MEMORY = 64 * MEGABYTE;
+    constexpr int AUTO_TUNE_INTERVAL_MS = 100; // Length of one statistics window
+    constexpr size_t AUTO_TUNE_SHRINK_WINDOWS = 50; // Quiet windows before a shard is halved
+    constexpr size_t AUTO_TUNE_HISTORY = 600; // Arrival-rate windows kept for percentiles (1 min)
+    constexpr size_t AUTO_TUNE_CHECK_RECORDS = 256; // Records a busy worker writes between clock reads
+    constexpr size_t DEFAULT_POLL_BUDGET = 1024;
+    constexpr size_t PUMP_ON_FULL_BUDGET = 64; // Entries a manual-pump producer writes when its lane is full
+    constexpr size_t URING_BUFFER_SIZE = 256 * KILOBYTE; // One registered write buffer
+    constexpr size_t URING_BUFFERS = 4; // Buffers cycled by the io_uring writer; all but one may be in flight
+    constexpr size_t MMAP_SEGMENT_SIZE = 16 * MEGABYTE; // Preallocated and mapped at a time, capped by maxFileSize
+    constexpr size_t MAX_MAPPED_FILES = 64; // Mapped log files the crash handler can trim
+    constexpr size_t DIRECT_IO_ALIGNMENT = 4096; // Offset and length unit of O_DIRECT writes
+    constexpr size_t DIRECT_BUFFER_SIZE = MEGABYTE; // Each of the two O_DIRECT buffers; also the DONTNEED chunk
+    constexpr size_t FILE_BUFFER_SIZE = 64 * KILOBYTE; // Write buffer of the plain file writer
+    constexpr int GZIP_LEVEL = 6; // zlib's default trade-off, for rotated files compressed in the background
+    constexpr int GZIP_STREAM_LEVEL = 1; // Frames compressed on the write path: speed over ratio
+    constexpr size_t GZIP_FRAME_SIZE = 256 * KILOBYTE; // Text compressed into one gzip member; lost at most on a crash
+    constexpr size_t COMPRESSION_CHUNK = 256 * KILOBYTE; // Read from a rotated file per gzwrite()
+    constexpr int COMPRESSION_NICE = 19; // Nice value of the compression thread
+    constexpr size_t CONSOLE_BUFFER_SIZE = 64 * KILOBYTE; // Stdout batch of the buffered console sink
 }
 
 // Set global spdlog error handler to suppress file rotation warnings
@@ -68,6 +164,4463 @@ namespace {
     static SpdlogErrorHandlerInitializer spdlog_init;
 }
 
+// Built-in asynchronous engine used when Config::asyncEngine selects one of
+// FreshLogger's own queue engines instead of spdlog's shared thread pool.
+namespace LoggerDetail {
+
+    /**
+     * @brief Kind of entry travelling through an engine queue
+     */
+    enum class RecordKind : uint8_t {
+        LOG,    ///< Regular log record
+        FLUSH,  ///< Flush barrier, completed once every earlier record is on the sinks
+        BATCH   ///< Records published together by one producer, written back to back
+    };
+
+    /**
+     * @brief Completion state of a queued flush barrier
+     */
+    struct FlushBarrier {
+        std::promise<void> done;
+        std::function<void()> callback;  ///< Optional, invoked on the backend worker
+        std::atomic<size_t> remaining{1};  ///< Shard copies not yet reached by a worker
+
+        /**
+         * @brief Mark one copy as reached
+         * @return True for the last copy, whose worker must flush and complete
+         */
+        bool arrive() { return remaining.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+        void complete() {
+            if (callback) {
+                try {
+                    callback();
+                } catch (...) {
+                    // A failing callback must not take down the backend worker
+                }
+            }
+            done.set_value();
+        }
+    };
+
+    /**
+     * @brief Lines a producer collects and queues as one entry; see Logger::Batch
+     *
+     * Each thread keeps its last batch and reuses it once the worker has
+     * written it, so a steady loop stops allocating after its first batches.
+     */
+    struct RecordBatch {
+        std::vector<spdlog::details::log_msg> messages;  ///< Payloads point into text once sealed
+        std::vector<size_t> offsets;                      ///< Start of each payload in text
+        std::string text;
+        spdlog::level::level_enum maxLevel = spdlog::level::trace;
+        std::atomic<bool> inUse{false};  ///< Held by a Batch or queued; cleared once written
+
+        /**
+         * @brief Empty batch for the calling thread, reusing its previous one when written
+         */
+        static std::shared_ptr<RecordBatch> acquire() {
+            thread_local std::shared_ptr<RecordBatch> cached;
+            if (!cached) {
+                cached = std::make_shared<RecordBatch>();
+            } else if (cached->inUse.load(std::memory_order_acquire)) {
+                // Still queued: start a new one sized like it
+                auto next = std::make_shared<RecordBatch>();
+                next->messages.reserve(cached->messages.capacity());
+                next->offsets.reserve(cached->offsets.capacity());
+                next->text.reserve(cached->text.capacity());
+                cached = std::move(next);
+            }
+            cached->messages.clear();
+            cached->offsets.clear();
+            cached->text.clear();
+            cached->maxLevel = spdlog::level::trace;
+            cached->inUse.store(true, std::memory_order_relaxed);
+            return cached;
+        }
+
+        void add(spdlog::string_view_t loggerName, spdlog::level::level_enum level, const std::string& message) {
+            offsets.push_back(text.size());
+            text.append(message);
+            messages.emplace_back(loggerName, level, spdlog::string_view_t{});
+            maxLevel = std::max(maxLevel, level);
+        }
+
+        /**
+         * @brief Add a range of lines sharing one level, timestamp and thread id
+         *
+         * Measures the range first so that each buffer grows at most once.
+         */
+        template<typename Iterator>
+        void addLines(spdlog::string_view_t loggerName, spdlog::level::level_enum level, Iterator first, Iterator last) {
+            size_t count = 0;
+            size_t bytes = 0;
+            for (Iterator it = first; it != last; ++it) {
+                ++count;
+                bytes += spdlog::string_view_t(*it).size();
+            }
+            messages.reserve(messages.size() + count);
+            offsets.reserve(offsets.size() + count);
+            text.reserve(text.size() + bytes);
+            const spdlog::details::log_msg prototype(loggerName, level, spdlog::string_view_t{});
+            for (; first != last; ++first) {
+                spdlog::string_view_t line(*first);
+                offsets.push_back(text.size());
+                text.append(line.data(), line.size());
+                messages.push_back(prototype);
+            }
+            maxLevel = std::max(maxLevel, level);
+        }
+
+        /**
+         * @brief Point every payload into text; call once all lines are added
+         */
+        void seal() {
+            for (size_t i = 0; i < messages.size(); ++i) {
+                size_t end = (i + 1 < offsets.size()) ? offsets[i + 1] : text.size();
+                messages[i].payload = spdlog::string_view_t(text.data() + offsets[i], end - offsets[i]);
+            }
+        }
+
+        /**
+         * @brief Hand the batch back to its thread for reuse
+         */
+        void release() { inUse.store(false, std::memory_order_release); }
+    };
+
+    /**
+     * @brief Kind of pages backing a queue's storage
+     */
+    enum class PageMode : uint8_t {
+        NORMAL,            ///< Regular pages
+        TRANSPARENT_HUGE,  ///< mmap + madvise(MADV_HUGEPAGE); the kernel may still use small pages
+        EXPLICIT_HUGE      ///< MAP_HUGETLB from the reserved pool, else TRANSPARENT_HUGE
+    };
+
+    /**
+     * @brief Anonymous mappings with an optional huge-page preference
+     *
+     * Huge-page requests are rounded up to HUGE_PAGE_SIZE so that unmap() can
+     * recompute the length whichever kind the kernel granted.
+     */
+    struct Pages {
+        static size_t roundUp(size_t length, size_t unit) { return (length + unit - 1) / unit * unit; }
+
+        /**
+         * @brief Map zero-filled memory, falling back to smaller pages when refused
+         * @param obtained Optional, receives the kind actually granted
+         * @throws std::bad_alloc when even regular pages cannot be mapped
+         */
+        static void* map(size_t length, PageMode mode, PageMode* obtained = nullptr) {
+            PageMode granted = PageMode::NORMAL;
+            void* address = MAP_FAILED;
+            if (mode != PageMode::NORMAL) {
+                length = roundUp(length, LoggerConstants::HUGE_PAGE_SIZE);
+            }
+#ifdef MAP_HUGETLB
+            if (mode == PageMode::EXPLICIT_HUGE) {
+                address = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                granted = PageMode::EXPLICIT_HUGE;
+            }
+#endif
+            if (address == MAP_FAILED) {
+                address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (address == MAP_FAILED) {
+                    throw std::bad_alloc();
+                }
+                granted = PageMode::NORMAL;
+#ifdef MADV_HUGEPAGE
+                if (mode != PageMode::NORMAL && madvise(address, length, MADV_HUGEPAGE) == 0) {
+                    granted = PageMode::TRANSPARENT_HUGE;
+                }
+#endif
+            }
+            if (obtained != nullptr) {
+                *obtained = granted;
+            }
+            return address;
+        }
+
+        static void unmap(void* address, size_t length, PageMode mode) {
+            if (mode != PageMode::NORMAL) {
+                length = roundUp(length, LoggerConstants::HUGE_PAGE_SIZE);
+            }
+            munmap(address, length);
+        }
+    };
+
+    /**
+     * @brief Standard allocator that maps huge pages unless the mode is NORMAL
+     */
+    template<typename T>
+    class PageAllocator {
+    public:
+        using value_type = T;
+
+        explicit PageAllocator(PageMode mode = PageMode::NORMAL) noexcept : m_mode(mode) {}
+        template<typename U>
+        PageAllocator(const PageAllocator<U>& other) noexcept : m_mode(other.mode()) {}
+
+        T* allocate(size_t count) {
+            if (m_mode == PageMode::NORMAL) {
+                return std::allocator<T>().allocate(count);
+            }
+            return static_cast<T*>(Pages::map(count * sizeof(T), m_mode));
+        }
+
+        void deallocate(T* pointer, size_t count) noexcept {
+            if (m_mode == PageMode::NORMAL) {
+                std::allocator<T>().deallocate(pointer, count);
+                return;
+            }
+            Pages::unmap(pointer, count * sizeof(T), m_mode);
+        }
+
+        [[nodiscard]] PageMode mode() const noexcept { return m_mode; }
+
+        template<typename U>
+        bool operator==(const PageAllocator<U>& other) const noexcept { return m_mode == other.mode(); }
+        template<typename U>
+        bool operator!=(const PageAllocator<U>& other) const noexcept { return m_mode != other.mode(); }
+
+    private:
+        PageMode m_mode;
+    };
+
+    /**
+     * @brief Per-thread slab of a few size classes for queued payloads
+     *
+     * The owning producer thread allocates without locking. Whoever frees a
+     * block (normally the backend worker) pushes it on the owner's remote-free
+     * list, which the owner reclaims with a single exchange when its local
+     * lists run dry. Chunks are mapped directly, so queued payloads neither
+     * contend on nor fragment the application's malloc heap. A slab outlives
+     * its thread until the last of its blocks has been freed.
+     */
+    class PayloadSlab {
+    public:
+        static constexpr size_t CLASS_COUNT = 5;
+        static constexpr size_t CLASS_SIZES[CLASS_COUNT] = {512, 1024, 2048, 4096, 8192};
+        static constexpr size_t CHUNK_SIZE = 256 * 1024;
+
+        PayloadSlab(const PayloadSlab&) = delete;
+        PayloadSlab& operator=(const PayloadSlab&) = delete;
+
+        /**
+         * @brief Slab of the calling thread, created on first use
+         */
+        static PayloadSlab& local() {
+            struct Holder {
+                PayloadSlab* slab = new PayloadSlab();
+                ~Holder() { slab->unref(); }
+            };
+            thread_local Holder holder;
+            return *holder.slab;
+        }
+
+        /**
+         * @brief Allocate from the calling thread's slab
+         * @return nullptr when bytes exceeds the largest size class
+         */
+        char* allocate(size_t bytes) {
+            size_t sizeClass = classFor(bytes + sizeof(Block));
+            if (sizeClass == CLASS_COUNT) {
+                return nullptr;
+            }
+            if (m_free[sizeClass] == nullptr) {
+                reclaimRemote();
+            }
+            Block* block = m_free[sizeClass];
+            if (block != nullptr) {
+                m_free[sizeClass] = block->next;
+            } else {
+                block = carve(sizeClass);
+            }
+            m_refs.fetch_add(1, std::memory_order_relaxed);
+            return reinterpret_cast<char*>(block + 1);
+        }
+
+        /**
+         * @brief Return a block to its owner's remote-free list; callable from any thread
+         */
+        static void free(char* data) {
+            Block* block = reinterpret_cast<Block*>(data) - 1;
+            PayloadSlab* owner = block->owner;
+            Block* head = owner->m_remote.load(std::memory_order_relaxed);
+            do {
+                block->next = head;
+            } while (!owner->m_remote.compare_exchange_weak(head, block, std::memory_order_release,
+                                                            std::memory_order_relaxed));
+            owner->unref();
+        }
+
+        /**
+         * @brief Bytes currently mapped by all slabs in the process
+         */
+        static size_t mappedBytes() { return s_mappedBytes.load(std::memory_order_relaxed); }
+
+    private:
+        struct alignas(16) Block {
+            PayloadSlab* owner;
+            Block* next;          ///< Free-list link
+            size_t sizeClass;
+        };
+
+        PayloadSlab() = default;
+
+        ~PayloadSlab() {
+            for (char* chunk : m_chunks) {
+                Pages::unmap(chunk, CHUNK_SIZE, PageMode::NORMAL);
+            }
+            s_mappedBytes.fetch_sub(m_chunks.size() * CHUNK_SIZE, std::memory_order_relaxed);
+        }
+
+        static size_t classFor(size_t bytes) {
+            size_t sizeClass = 0;
+            while (sizeClass < CLASS_COUNT && CLASS_SIZES[sizeClass] < bytes) {
+                ++sizeClass;
+            }
+            return sizeClass;
+        }
+
+        void unref() {
+            if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete this;
+            }
+        }
+
+        void reclaimRemote() {
+            Block* list = m_remote.exchange(nullptr, std::memory_order_acquire);
+            while (list != nullptr) {
+                Block* next = list->next;
+                list->next = m_free[list->sizeClass];
+                m_free[list->sizeClass] = list;
+                list = next;
+            }
+        }
+
+        Block* carve(size_t sizeClass) {
+            size_t size = CLASS_SIZES[sizeClass];
+            if (m_chunks.empty() || m_chunkUsed + size > CHUNK_SIZE) {
+                m_chunks.push_back(static_cast<char*>(Pages::map(CHUNK_SIZE, PageMode::NORMAL)));
+                s_mappedBytes.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+                m_chunkUsed = 0;
+            }
+            auto* block = new (m_chunks.back() + m_chunkUsed) Block{this, nullptr, sizeClass};
+            m_chunkUsed += size;
+            return block;
+        }
+
+        std::atomic<size_t> m_refs{1};  ///< Outstanding blocks, plus one while the thread lives
+        std::atomic<Block*> m_remote{nullptr};
+        Block* m_free[CLASS_COUNT] = {};
+        std::vector<char*> m_chunks;
+        size_t m_chunkUsed = 0;
+        inline static std::atomic<size_t> s_mappedBytes{0};
+    };
+
+    /**
+     * @brief Queue entry: an owning copy of spdlog's log_msg plus control data
+     *
+     * Name and payload normally live in log_msg_buffer's own storage. A record
+     * built with a PayloadSlab keeps them in a slab block instead when they are
+     * too long for the inline buffer; moves carry the block along and copies
+     * fall back to log_msg_buffer storage.
+     */
+    struct QueuedRecord : public spdlog::details::log_msg_buffer {
+        RecordKind kind = RecordKind::LOG;
+        std::shared_ptr<FlushBarrier> barrier;  ///< Completed for FLUSH entries
+        std::shared_ptr<RecordBatch> batch;     ///< Lines of BATCH entries
+        bool batchContinues = false;            ///< More lines of the same batch follow in this queue
+
+        QueuedRecord() = default;
+        explicit QueuedRecord(const spdlog::details::log_msg& msg)
+            : spdlog::details::log_msg_buffer(msg) {}
+
+        QueuedRecord(const spdlog::details::log_msg& msg, PayloadSlab& slab) {
+            size_t nameSize = msg.logger_name.size();
+            size_t payloadSize = msg.payload.size();
+            char* data = slab.allocate(nameSize + payloadSize);
+            if (data == nullptr) {
+                spdlog::details::log_msg_buffer::operator=(spdlog::details::log_msg_buffer(msg));
+                return;
+            }
+            spdlog::details::log_msg::operator=(msg);
+            std::memcpy(data, msg.logger_name.data(), nameSize);
+            std::memcpy(data + nameSize, msg.payload.data(), payloadSize);
+            m_slabData = data;
+            m_nameSize = nameSize;
+            m_payloadSize = payloadSize;
+            pointAtSlab();
+        }
+
+        QueuedRecord(const QueuedRecord& other)
+            : spdlog::details::log_msg_buffer(static_cast<const spdlog::details::log_msg&>(other)),
+              kind(other.kind),
+              barrier(other.barrier),
+              batch(other.batch),
+              batchContinues(other.batchContinues) {}
+
+        QueuedRecord(QueuedRecord&& other) noexcept
+            : spdlog::details::log_msg_buffer(std::move(other)),
+              kind(other.kind),
+              barrier(std::move(other.barrier)),
+              batch(std::move(other.batch)),
+              batchContinues(other.batchContinues) {
+            takeSlab(other);
+        }
+
+        QueuedRecord& operator=(const QueuedRecord& other) {
+            if (this != &other) {
+                releaseSlab();
+                spdlog::details::log_msg_buffer::operator=(
+                    spdlog::details::log_msg_buffer(static_cast<const spdlog::details::log_msg&>(other)));
+                kind = other.kind;
+                barrier = other.barrier;
+                batch = other.batch;
+                batchContinues = other.batchContinues;
+            }
+            return *this;
+        }
+
+        QueuedRecord& operator=(QueuedRecord&& other) noexcept {
+            if (this != &other) {
+                releaseSlab();
+                spdlog::details::log_msg_buffer::operator=(std::move(other));
+                kind = other.kind;
+                barrier = std::move(other.barrier);
+                batch = std::move(other.batch);
+                batchContinues = other.batchContinues;
+                takeSlab(other);
+            }
+            return *this;
+        }
+
+        ~QueuedRecord() { releaseSlab(); }
+
+    private:
+        void pointAtSlab() {
+            logger_name = spdlog::string_view_t(m_slabData, m_nameSize);
+            payload = spdlog::string_view_t(m_slabData + m_nameSize, m_payloadSize);
+        }
+
+        void takeSlab(QueuedRecord& other) {
+            m_slabData = std::exchange(other.m_slabData, nullptr);
+            m_nameSize = other.m_nameSize;
+            m_payloadSize = other.m_payloadSize;
+            if (m_slabData != nullptr) {
+                pointAtSlab();
+            }
+        }
+
+        void releaseSlab() {
+            if (m_slabData != nullptr) {
+                PayloadSlab::free(m_slabData);
+                m_slabData = nullptr;
+            }
+        }
+
+        char* m_slabData = nullptr;
+        size_t m_nameSize = 0;
+        size_t m_payloadSize = 0;
+    };
+
+    /**
+     * @brief Bounded queue of records; blocking is handled by the engine
+     */
+    class RecordQueue {
+    public:
+        virtual ~RecordQueue() = default;
+
+        /// Moves the record in only on success; returns false when full
+        virtual bool tryPush(QueuedRecord&& record) = 0;
+        /// Moves the oldest record out; returns false when empty
+        virtual bool tryPop(QueuedRecord& record) = 0;
+
+        /// Copies a front-end message in without building a QueuedRecord; see storesMessages()
+        virtual bool tryPushMessage(const spdlog::details::log_msg& /*msg*/) { return false; }
+        /// Copies a batch's leading messages in back to back; returns how many, see storesMessages()
+        virtual size_t tryPushMessages(const spdlog::details::log_msg* /*messages*/, size_t /*count*/) { return 0; }
+        /// True when tryPushMessage() and tryPushMessages() are implemented
+        [[nodiscard]] virtual bool storesMessages() const { return false; }
+
+        /// Return storage not holding queued records to the OS; called by the consumer when idle
+        virtual void releaseMemory() {}
+
+        /// Change the capacity keeping queued records; false when unsupported or they would not fit
+        virtual bool resize(size_t /*capacity*/) { return false; }
+
+        [[nodiscard]] virtual size_t size() const = 0;
+        [[nodiscard]] virtual size_t capacity() const = 0;
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        using Visitor = void (*)(const spdlog::details::log_msg& msg, void* context);
+
+        /**
+         * @brief Visit queued LOG records oldest first without locking or freeing
+         * @note Only for the crash handler, after the consumer has been parked
+         */
+        virtual void visitPending(Visitor visitor, void* context) const = 0;
+
+    protected:
+        /// Visit a queued entry's LOG records; a BATCH holds several
+        static void visitRecord(const QueuedRecord& record, Visitor visitor, void* context) {
+            if (record.kind == RecordKind::LOG) {
+                visitor(record, context);
+            } else if (record.kind == RecordKind::BATCH) {
+                for (const auto& msg : record.batch->messages) {
+                    visitor(msg, context);
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Mutex-protected ring buffer, equivalent to spdlog's circular_q
+     *
+     * Slots are mapped directly and a record is only constructed in its slot
+     * while queued, so the pages of free slots hold nothing and can be handed
+     * back to the OS, like a ByteRingQueue's.
+     */
+    class RingQueue final : public RecordQueue {
+    public:
+        /**
+         * @param capacity Number of slots, at least 1
+         * @param prefault Touch every page now; otherwise pages are faulted in as the ring fills
+         * @param pages Preferred page kind
+         */
+        explicit RingQueue(size_t capacity, bool prefault = true, PageMode pages = PageMode::NORMAL)
+            : m_slotCount(std::max<size_t>(capacity, 1)),
+              m_slots(mapSlots(m_slotCount, pages, m_pageMode, prefault)),
+              m_capacity(m_slotCount) {}
+
+        ~RingQueue() override {
+            for (size_t n = m_count.load(std::memory_order_relaxed); n > 0; --n) {
+                m_slots[m_head].~QueuedRecord();
+                m_head = (m_head + 1) % m_slotCount;
+            }
+            Pages::unmap(m_slots, m_slotCount * sizeof(QueuedRecord), m_pageMode);
+        }
+
+        RingQueue(const RingQueue&) = delete;
+        RingQueue& operator=(const RingQueue&) = delete;
+
+        bool tryPush(QueuedRecord&& record) override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_count.load(std::memory_order_relaxed) == m_slotCount) {
+                return false;
+            }
+            new (&m_slots[m_tail]) QueuedRecord(std::move(record));
+            m_tail = (m_tail + 1) % m_slotCount;
+            m_count.fetch_add(1, std::memory_order_seq_cst);
+            return true;
+        }
+
+        bool tryPop(QueuedRecord& record) override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_count.load(std::memory_order_relaxed) == 0) {
+                return false;
+            }
+            record = std::move(m_slots[m_head]);
+            m_slots[m_head].~QueuedRecord();
+            m_head = (m_head + 1) % m_slotCount;
+            m_count.fetch_sub(1, std::memory_order_seq_cst);
+            return true;
+        }
+
+        /**
+         * @brief Move the queued records into a new slot array of the given size
+         * @note The array is mapped before taking the lock and unmapped after
+         *       it; producers only wait while the queued records are moved across
+         */
+        bool resize(size_t capacity) override {
+            capacity = std::max<size_t>(capacity, 1);
+            PageMode mode = m_pageMode;
+            QueuedRecord* slots = mapSlots(capacity, mode, mode, false);
+            bool moved = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                size_t count = m_count.load(std::memory_order_relaxed);
+                if (count <= capacity) {
+                    for (size_t i = 0; i < count; ++i) {
+                        QueuedRecord& old = m_slots[(m_head + i) % m_slotCount];
+                        new (&slots[i]) QueuedRecord(std::move(old));
+                        old.~QueuedRecord();
+                    }
+                    std::swap(slots, m_slots);
+                    std::swap(capacity, m_slotCount);
+                    std::swap(mode, m_pageMode);
+                    m_head = 0;
+                    m_tail = count % m_slotCount;
+                    m_capacity.store(m_slotCount, std::memory_order_relaxed);
+                    moved = true;
+                }
+            }
+            // The old array after a move, otherwise the unused new one
+            Pages::unmap(slots, capacity * sizeof(QueuedRecord), mode);
+            return moved;
+        }
+
+        [[nodiscard]] size_t size() const override { return m_count.load(std::memory_order_seq_cst); }
+        [[nodiscard]] size_t capacity() const override { return m_capacity.load(std::memory_order_relaxed); }
+
+        void releaseMemory() override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            size_t count = m_count.load(std::memory_order_relaxed);
+            if (count == 0) {
+                m_head = 0;
+                m_tail = 0;
+                dropSlots(0, m_slotCount);
+            } else if (count < m_slotCount) {
+                // Free slots are [tail, head), possibly wrapping past the end
+                if (m_tail >= m_head) {
+                    dropSlots(m_tail, m_slotCount);
+                    dropSlots(0, m_head);
+                } else {
+                    dropSlots(m_tail, m_head);
+                }
+            }
+        }
+
+        void visitPending(Visitor visitor, void* context) const override {
+            size_t index = m_head;
+            for (size_t n = m_count.load(std::memory_order_acquire); n > 0; --n) {
+                visitRecord(m_slots[index], visitor, context);
+                index = (index + 1) % m_slotCount;
+            }
+        }
+
+    private:
+        static QueuedRecord* mapSlots(size_t count, PageMode pages, PageMode& obtained, bool prefault) {
+            size_t length = count * sizeof(QueuedRecord);
+            auto* slots = static_cast<QueuedRecord*>(Pages::map(length, pages, &obtained));
+            if (prefault) {
+                // Faults every page in on the constructing thread (NUMA first touch)
+                std::memset(static_cast<void*>(slots), 0, length);
+            }
+            return slots;
+        }
+
+        /**
+         * @brief Drop the whole pages inside slots [begin, end); none of them holds a record
+         */
+        void dropSlots(size_t begin, size_t end) {
+            size_t page = (m_pageMode == PageMode::EXPLICIT_HUGE)
+                ? LoggerConstants::HUGE_PAGE_SIZE
+                : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            size_t first = (begin * sizeof(QueuedRecord) + page - 1) / page * page;
+            size_t last = end * sizeof(QueuedRecord) / page * page;
+            if (first < last) {
+                madvise(reinterpret_cast<char*>(m_slots) + first, last - first, MADV_DONTNEED);
+            }
+        }
+
+        std::mutex m_mutex;
+        size_t m_slotCount;
+        PageMode m_pageMode = PageMode::NORMAL;
+        QueuedRecord* m_slots;
+        size_t m_head = 0;
+        size_t m_tail = 0;
+        std::atomic<size_t> m_count{0};
+        std::atomic<size_t> m_capacity;
+    };
+
+    /**
+     * @brief Bounded lock-free multi-producer queue (Vyukov sequence-counter ring)
+     *
+     * Each slot carries a sequence number telling producers and the consumer
+     * whether it is free or published, so producers only contend on one CAS of
+     * the enqueue cursor and never block each other. Slots and both cursors are
+     * padded to separate cache lines. Capacity is rounded up to a power of two.
+     * Free slots are never released: each keeps the sequence number producers
+     * synchronize on, and a producer may claim one at any moment.
+     */
+    class LockFreeQueue final : public RecordQueue {
+    public:
+        explicit LockFreeQueue(size_t capacity, PageMode pages = PageMode::NORMAL)
+            : m_mask(roundUpToPowerOfTwo(std::max<size_t>(capacity, 2)) - 1),
+              m_slots(m_mask + 1, PageAllocator<Slot>(pages)) {
+            for (size_t i = 0; i <= m_mask; ++i) {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool tryPush(QueuedRecord&& record) override {
+            size_t pos = m_enqueuePos.value.load(std::memory_order_relaxed);
+            while (true) {
+                Slot& slot = m_slots[pos & m_mask];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (m_enqueuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst,
+                                                                 std::memory_order_relaxed)) {
+                        slot.record = std::move(record);
+                        slot.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_enqueuePos.value.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool tryPop(QueuedRecord& record) override {
+            size_t pos = m_dequeuePos.value.load(std::memory_order_relaxed);
+            while (true) {
+                Slot& slot = m_slots[pos & m_mask];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0) {
+                    if (m_dequeuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst,
+                                                                 std::memory_order_relaxed)) {
+                        record = std::move(slot.record);
+                        slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_dequeuePos.value.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        [[nodiscard]] size_t size() const override {
+            size_t dequeued = m_dequeuePos.value.load(std::memory_order_seq_cst);
+            size_t enqueued = m_enqueuePos.value.load(std::memory_order_seq_cst);
+            return enqueued > dequeued ? enqueued - dequeued : 0;
+        }
+
+        [[nodiscard]] size_t capacity() const override { return m_mask + 1; }
+
+        void visitPending(Visitor visitor, void* context) const override {
+            size_t pos = m_dequeuePos.value.load(std::memory_order_acquire);
+            while (true) {
+                const Slot& slot = m_slots[pos & m_mask];
+                if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                    break;
+                }
+                visitRecord(slot.record, visitor, context);
+                ++pos;
+            }
+        }
+
+    private:
+        struct alignas(LoggerConstants::CACHE_LINE_SIZE) Slot {
+            std::atomic<size_t> sequence{0};
+            QueuedRecord record;
+        };
+
+        struct alignas(LoggerConstants::CACHE_LINE_SIZE) Cursor {
+            std::atomic<size_t> value{0};
+        };
+
+        static size_t roundUpToPowerOfTwo(size_t value) {
+            size_t result = 1;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        const size_t m_mask;
+        std::vector<Slot, PageAllocator<Slot>> m_slots;
+        Cursor m_enqueuePos;
+        Cursor m_dequeuePos;
+    };
+
+    /**
+     * @brief Mutex-protected ring of variable-length records with a byte capacity
+     *
+     * Each record is stored contiguously as a header followed by the logger
+     * name and payload, so the queue's memory is fixed at construction no matter
+     * how long messages are, and pushing a front-end message copies it straight
+     * into the ring without allocating. A record that does not fit before the
+     * end of the buffer leaves a wrap marker and starts again at offset 0.
+     * Payloads longer than the whole ring are truncated. The ring is mapped
+     * directly rather than taken from the malloc heap, optionally on huge pages.
+     */
+    class ByteRingQueue final : public RecordQueue {
+    public:
+        /**
+         * @param capacityBytes Ring size, rounded up to at least MIN_QUEUE_BYTES
+         * @param prefault Touch every page now; otherwise pages are faulted in as the ring fills
+         * @param pages Preferred page kind; see pageMode() for the one granted
+         */
+        explicit ByteRingQueue(size_t capacityBytes, bool prefault = true, PageMode pages = PageMode::NORMAL)
+            : m_capacity(alignUp(std::max(capacityBytes, LoggerConstants::MIN_QUEUE_BYTES))),
+              m_bytes(static_cast<char*>(Pages::map(m_capacity, pages, &m_pageMode))) {
+            if (prefault) {
+                // Faults every page in on the constructing thread (NUMA first touch)
+                std::memset(m_bytes, 0, m_capacity);
+            }
+        }
+
+        ~ByteRingQueue() override {
+            QueuedRecord record;
+            while (tryPop(record)) {
+            }
+            Pages::unmap(m_bytes, m_capacity, m_pageMode);
+        }
+
+        ByteRingQueue(const ByteRingQueue&) = delete;
+        ByteRingQueue& operator=(const ByteRingQueue&) = delete;
+
+        bool tryPush(QueuedRecord&& record) override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Header* header = write(record);
+            if (header == nullptr) {
+                return false;
+            }
+            header->kind = record.kind;
+            if (record.barrier) {
+                header->barrier = new std::shared_ptr<FlushBarrier>(std::move(record.barrier));
+            }
+            return true;
+        }
+
+        bool tryPushMessage(const spdlog::details::log_msg& msg) override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return write(msg) != nullptr;
+        }
+
+        /**
+         * @brief Copy all messages in at once, or none
+         *
+         * A batch too large to ever fit together is copied in as far as it
+         * fits, so the caller can push the rest once the worker makes room.
+         */
+        size_t tryPushMessages(const spdlog::details::log_msg* messages, size_t count) override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            size_t total = 0;
+            size_t largest = 0;
+            for (size_t i = 0; i < count; ++i) {
+                size_t size = recordSize(messages[i]);
+                total += size;
+                largest = std::max(largest, size);
+            }
+            // A batch wraps at most once, wasting less than one record at the end
+            size_t free = m_capacity - m_used;
+            if (total + largest <= m_capacity && free < total + largest) {
+                return 0;
+            }
+            size_t pushed = 0;
+            Header* header = nullptr;
+            while (pushed < count && (header = write(messages[pushed])) != nullptr) {
+                header->batchContinues = (pushed + 1 < count);
+                ++pushed;
+            }
+            return pushed;
+        }
+
+        [[nodiscard]] bool storesMessages() const override { return true; }
+
+        bool tryPop(QueuedRecord& record) override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_count.load(std::memory_order_relaxed) == 0) {
+                return false;
+            }
+            Header* header = front();
+            spdlog::details::log_msg view;
+            fill(view, *header);
+            record = QueuedRecord(view);
+            record.kind = header->kind;
+            record.batchContinues = header->batchContinues;
+            if (header->barrier != nullptr) {
+                record.barrier = std::move(*header->barrier);
+                delete header->barrier;
+            }
+
+            m_used -= header->size;
+            m_head += header->size;
+            if (m_head == m_capacity) {
+                m_head = 0;
+            }
+            if (m_count.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+                m_head = 0;
+                m_tail = 0;
+                m_used = 0;
+            }
+            return true;
+        }
+
+        [[nodiscard]] size_t size() const override { return m_count.load(std::memory_order_seq_cst); }
+        [[nodiscard]] size_t capacity() const override { return m_capacity; }
+        [[nodiscard]] PageMode pageMode() const { return m_pageMode; }
+
+        void releaseMemory() override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_count.load(std::memory_order_relaxed) == 0) {
+                m_head = 0;
+                m_tail = 0;
+                m_used = 0;
+                dropPages(0, m_capacity);
+            } else if (m_used < m_capacity) {
+                // Free space is [tail, head), possibly wrapping past the end
+                if (m_tail >= m_head) {
+                    dropPages(m_tail, m_capacity);
+                    dropPages(0, m_head);
+                } else {
+                    dropPages(m_tail, m_head);
+                }
+            }
+        }
+
+        void visitPending(Visitor visitor, void* context) const override {
+            size_t offset = m_head;
+            for (size_t n = m_count.load(std::memory_order_acquire); n > 0; --n) {
+                if (m_capacity - offset < sizeof(Header) || headerAt(offset)->size == WRAP_MARKER) {
+                    offset = 0;
+                }
+                const Header* header = headerAt(offset);
+                if (header->kind == RecordKind::LOG) {
+                    spdlog::details::log_msg view;
+                    fill(view, *header);
+                    visitor(view, context);
+                }
+                offset += header->size;
+                if (offset == m_capacity) {
+                    offset = 0;
+                }
+            }
+        }
+
+    private:
+        struct Header {
+            uint32_t size;                  ///< Bytes taken by the record, WRAP_MARKER for a wrap
+            uint32_t nameSize;
+            uint32_t payloadSize;
+            RecordKind kind;
+            bool batchContinues;            ///< Set by tryPushMessages() on all but a batch's last line
+            spdlog::level::level_enum level;
+            size_t threadId;
+            spdlog::log_clock::time_point time;
+            spdlog::source_loc source;      ///< Points at string literals, safe to keep
+            std::shared_ptr<FlushBarrier>* barrier;  ///< Owned, FLUSH records only
+        };
+
+        static constexpr uint32_t WRAP_MARKER = 0;
+        static constexpr size_t ALIGNMENT = alignof(Header);
+
+        static size_t alignUp(size_t value) { return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+        /**
+         * @brief Drop the whole pages inside [begin, end); they read back as zeros
+         */
+        void dropPages(size_t begin, size_t end) {
+            size_t page = (m_pageMode == PageMode::EXPLICIT_HUGE)
+                ? LoggerConstants::HUGE_PAGE_SIZE
+                : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            begin = (begin + page - 1) / page * page;
+            end = end / page * page;
+            if (begin < end) {
+                madvise(m_bytes + begin, end - begin, MADV_DONTNEED);
+            }
+        }
+
+        Header* headerAt(size_t offset) { return reinterpret_cast<Header*>(m_bytes + offset); }
+        const Header* headerAt(size_t offset) const { return reinterpret_cast<const Header*>(m_bytes + offset); }
+
+        Header* front() {
+            if (m_capacity - m_head < sizeof(Header) || headerAt(m_head)->size == WRAP_MARKER) {
+                m_used -= m_capacity - m_head;
+                m_head = 0;
+            }
+            return headerAt(m_head);
+        }
+
+        void fill(spdlog::details::log_msg& view, const Header& header) const {
+            const char* name = reinterpret_cast<const char*>(&header + 1);
+            view.logger_name = spdlog::string_view_t(name, header.nameSize);
+            view.payload = spdlog::string_view_t(name + header.nameSize, header.payloadSize);
+            view.level = header.level;
+            view.time = header.time;
+            view.thread_id = header.threadId;
+            view.source = header.source;
+        }
+
+        /**
+         * @brief Find room for a record of the given size; caller holds m_mutex
+         * @return Offset of the reserved bytes, or m_capacity when full
+         */
+        size_t reserve(size_t size) {
+            size_t free = m_capacity - m_used;
+            if (free < size) {
+                return m_capacity;
+            }
+            if (m_tail >= m_head) {
+                size_t atEnd = m_capacity - m_tail;
+                if (atEnd < size) {
+                    // Only whole records are stored, so wrap if the start has room
+                    if (free - atEnd < size) {
+                        return m_capacity;
+                    }
+                    if (atEnd >= sizeof(uint32_t)) {
+                        headerAt(m_tail)->size = WRAP_MARKER;
+                    }
+                    m_used += atEnd;
+                    m_tail = 0;
+                }
+            }
+            size_t offset = m_tail;
+            m_tail += size;
+            if (m_tail == m_capacity) {
+                m_tail = 0;
+            }
+            m_used += size;
+            return offset;
+        }
+
+        size_t recordSize(const spdlog::details::log_msg& msg) const {
+            size_t nameSize = std::min(msg.logger_name.size(), MAX_NAME_SIZE);
+            size_t payloadSize = std::min(msg.payload.size(), m_capacity - sizeof(Header) - nameSize);
+            return alignUp(sizeof(Header) + nameSize + payloadSize);
+        }
+
+        Header* write(const spdlog::details::log_msg& msg) {
+            size_t nameSize = std::min(msg.logger_name.size(), MAX_NAME_SIZE);
+            size_t payloadSize = std::min(msg.payload.size(), m_capacity - sizeof(Header) - nameSize);
+            size_t size = recordSize(msg);
+            size_t offset = reserve(size);
+            if (offset == m_capacity) {
+                return nullptr;
+            }
+
+            Header* header = headerAt(offset);
+            header->size = static_cast<uint32_t>(size);
+            header->nameSize = static_cast<uint32_t>(nameSize);
+            header->payloadSize = static_cast<uint32_t>(payloadSize);
+            header->kind = RecordKind::LOG;
+            header->batchContinues = false;
+            header->level = msg.level;
+            header->threadId = msg.thread_id;
+            header->time = msg.time;
+            header->source = msg.source;
+            header->barrier = nullptr;
+            char* name = reinterpret_cast<char*>(header + 1);
+            std::memcpy(name, msg.logger_name.data(), nameSize);
+            std::memcpy(name + nameSize, msg.payload.data(), payloadSize);
+            m_count.fetch_add(1, std::memory_order_seq_cst);
+            return header;
+        }
+
+        static constexpr size_t MAX_NAME_SIZE = 256;
+
+        std::mutex m_mutex;
+        size_t m_capacity;
+        PageMode m_pageMode = PageMode::NORMAL;  ///< Set by Pages::map before m_bytes is stored
+        char* m_bytes;
+        size_t m_head = 0;   ///< Offset of the oldest record
+        size_t m_tail = 0;   ///< Offset where the next record goes
+        size_t m_used = 0;   ///< Bytes taken by records and wrap gaps
+        std::atomic<size_t> m_count{0};
+    };
+
+    /**
+     * @brief Backend side of an engine: receives records on the worker thread
+     */
+    class RecordProcessor {
+    public:
+        virtual ~RecordProcessor() = default;
+        /**
+         * @return True when the record asks for a flush; the engine decides when it runs
+         */
+        virtual bool processLog(const spdlog::details::log_msg& msg, size_t worker) = 0;
+        virtual void processFlush() = 0;
+    };
+
+    /**
+     * @brief NUMA nodes and their CPUs as reported by sysfs
+     *
+     * Read from /sys/devices/system/node, so libnuma is not required. Hosts
+     * without that directory (or containers hiding it) are reported as a
+     * single node holding every CPU.
+     */
+    struct NumaTopology {
+        struct Node {
+            int id = 0;
+            std::vector<int> cpus;
+        };
+
+        std::vector<Node> nodes;
+        std::vector<size_t> cpuToNode;  ///< Index into nodes, by CPU number
+        bool detected = false;          ///< False when the single-node fallback was used
+
+        static const NumaTopology& system() {
+            static const NumaTopology topology = detect();
+            return topology;
+        }
+
+        /**
+         * @brief Index into nodes of the node the calling thread is running on
+         */
+        [[nodiscard]] size_t currentNode() const {
+            int cpu = sched_getcpu();
+            if (cpu < 0 || static_cast<size_t>(cpu) >= cpuToNode.size()) {
+                return 0;
+            }
+            return cpuToNode[static_cast<size_t>(cpu)];
+        }
+
+        /**
+         * @brief Restrict the calling thread to the CPUs of one node (best effort)
+         */
+        void pinToNode(size_t node) const {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : nodes[node].cpus) {
+                if (cpu < CPU_SETSIZE) {
+                    CPU_SET(cpu, &set);
+                }
+            }
+            // Fails harmlessly when a cpuset forbids every CPU of the node
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+
+        /**
+         * @brief Parse a sysfs cpulist such as "0-3,8-11"
+         */
+        static std::vector<int> parseCpuList(const std::string& list) {
+            std::vector<int> cpus;
+            std::stringstream stream(list);
+            std::string range;
+            while (std::getline(stream, range, ',')) {
+                if (range.empty() || !std::isdigit(static_cast<unsigned char>(range[0]))) {
+                    continue;
+                }
+                size_t dash = range.find('-');
+                int first = std::stoi(range.substr(0, dash));
+                int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+            return cpus;
+        }
+
+        static NumaTopology detect() {
+            NumaTopology topology;
+            std::error_code ec;
+            std::filesystem::directory_iterator it("/sys/devices/system/node", ec);
+            for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+                std::string name = it->path().filename().string();
+                if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                    !std::all_of(name.begin() + 4, name.end(), [](unsigned char c) { return std::isdigit(c); })) {
+                    continue;
+                }
+                std::ifstream cpulist(it->path() / "cpulist");
+                std::string list;
+                std::getline(cpulist, list);
+                Node node;
+                node.id = std::stoi(name.substr(4));
+                node.cpus = parseCpuList(list);
+                if (!node.cpus.empty()) { // Memory-only nodes get no queue
+                    topology.nodes.push_back(std::move(node));
+                }
+            }
+            topology.detected = !topology.nodes.empty();
+            if (!topology.detected) {
+                Node all;
+                unsigned count = std::max(1U, std::thread::hardware_concurrency());
+                for (unsigned cpu = 0; cpu < count; ++cpu) {
+                    all.cpus.push_back(static_cast<int>(cpu));
+                }
+                topology.nodes.push_back(std::move(all));
+            }
+            std::sort(topology.nodes.begin(), topology.nodes.end(),
+                      [](const Node& a, const Node& b) { return a.id < b.id; });
+
+            for (size_t index = 0; index < topology.nodes.size(); ++index) {
+                for (int cpu : topology.nodes[index].cpus) {
+                    if (static_cast<size_t>(cpu) >= topology.cpuToNode.size()) {
+                        topology.cpuToNode.resize(static_cast<size_t>(cpu) + 1, 0);
+                    }
+                    topology.cpuToNode[static_cast<size_t>(cpu)] = index;
+                }
+            }
+            return topology;
+        }
+    };
+
+    /**
+     * @brief Engine tuning derived from Logger::Config
+     */
+    struct EngineOptions {
+        size_t queueSize = LoggerConstants::DEFAULT_QUEUE_SIZE;
+        size_t priorityQueueSize = LoggerConstants::DEFAULT_PRIORITY_QUEUE_SIZE;
+        spdlog::level::level_enum priorityLevel = spdlog::level::err;
+        bool lockFree = false;              ///< Use LockFreeQueue instead of RingQueue for the normal shards
+        bool byteRing = false;              ///< Use ByteRingQueue for every lane; sized by queueBytes
+        size_t queueBytes = LoggerConstants::DEFAULT_QUEUE_BYTES; ///< Normal-lane bytes, split between shards
+        std::chrono::milliseconds releaseAfter{0}; ///< Idle time before workers return queue memory; 0 disables
+        std::chrono::milliseconds commitWindow{0}; ///< Longest a flush request waits for a backlog; 0 flushes each
+        PageMode pages = PageMode::NORMAL;  ///< Page kind backing every lane's storage
+        bool slab = false;                  ///< Keep long payloads in the producer's PayloadSlab
+        bool autoTune = false;              ///< Track burst statistics and resize RingQueue shards
+        size_t autoTuneMinSize = LoggerConstants::DEFAULT_AUTO_TUNE_MIN_QUEUE_SIZE; ///< Records, all shards
+        size_t autoTuneMaxBytes = LoggerConstants::DEFAULT_AUTO_TUNE_MAX_QUEUE_MEMORY; ///< Slot memory, all shards
+        size_t shards = 1;                  ///< Normal-lane queues; queueSize is split between them
+        size_t workers = 1;                 ///< Backend workers, capped at the shard count
+        bool numa = false;                  ///< One shard and pinned worker per NUMA node; overrides shards/workers
+        bool manual = false;                ///< No workers: the application drains with poll(); overrides workers
+        std::vector<spdlog::sink_ptr> workerSinks; ///< EngineLogger only: extra sink per worker, by index
+        bool crashHandler = false;          ///< Register with CrashHandler for emergency drains
+        std::string crashLogPath;           ///< File the crash handler appends to (stdout when empty)
+    };
+
+    /**
+     * @brief Normal-lane statistics gathered by an auto-tuning engine
+     */
+    struct QueueStats {
+        size_t capacity = 0;              ///< Current capacity in records, all shards
+        size_t highWaterMark = 0;         ///< Most records ever queued in one shard
+        uint64_t blockedPushes = 0;       ///< Records whose producer had to wait for space
+        uint64_t resizes = 0;             ///< Shard capacity changes made so far
+        double arrivalRateMedian = 0.0;   ///< Records/s into a shard, median of recent busy windows
+        double arrivalRateP99 = 0.0;      ///< 99th percentile of the same windows
+        double arrivalRatePeak = 0.0;     ///< Highest window rate since start
+        size_t recommendedQueueSize = 0;  ///< Static Config::queueSize that would have absorbed the bursts seen
+    };
+
+    class QueueEngine;
+
+    /**
+     * @brief Open memory-mapped log files, so that a crash leaves them at their real length
+     *
+     * A mapped file is preallocated past its contents while open. MmapWriter
+     * publishes its written length here; CrashHandler trims every registered
+     * file to it before appending drained records.
+     */
+    struct MappedFiles {
+        struct Entry {
+            std::atomic<int> slot;  ///< Descriptor + 1; 0 while free, -1 while being claimed
+            std::atomic<uint64_t> length;
+        };
+
+        /**
+         * @return Slot to publish lengths in, or nullptr when all are taken
+         */
+        static Entry* claim(int fd, uint64_t length) {
+            for (auto& entry : s_entries) {
+                int expected = 0;
+                if (entry.slot.load(std::memory_order_relaxed) == 0 &&
+                    entry.slot.compare_exchange_strong(expected, -1, std::memory_order_acq_rel)) {
+                    entry.length.store(length, std::memory_order_relaxed);
+                    entry.slot.store(fd + 1, std::memory_order_release);
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+
+        static void release(Entry* entry) {
+            if (entry != nullptr) {
+                entry->slot.store(0, std::memory_order_release);
+            }
+        }
+
+        /**
+         * @brief Truncate every open mapped file to its written length; async-signal-safe
+         */
+        static void trimAll() {
+            for (auto& entry : s_entries) {
+                int slot = entry.slot.load(std::memory_order_acquire);
+                if (slot > 0) {
+                    int ignored = ::ftruncate(slot - 1, static_cast<off_t>(entry.length.load(std::memory_order_relaxed)));
+                    (void)ignored;
+                }
+            }
+        }
+
+    private:
+        static inline Entry s_entries[LoggerConstants::MAX_MAPPED_FILES] = {};
+    };
+
+    /**
+     * @brief Process-wide handler for SIGSEGV, SIGABRT, SIGBUS and SIGFPE
+     *
+     * Installed while at least one crash-safe engine exists. On a fatal signal it
+     * parks each engine's worker, appends the still-queued records to the
+     * engine's log file with write(2) through a preallocated buffer, restores
+     * the previous handler and re-raises the signal.
+     */
+    class CrashHandler {
+    public:
+        static void registerEngine(QueueEngine* engine);
+        static void unregisterEngine(QueueEngine* engine);
+
+    private:
+        static constexpr int SIGNALS[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE};
+        static constexpr size_t SIGNAL_COUNT = sizeof(SIGNALS) / sizeof(SIGNALS[0]);
+
+        static void handleSignal(int signal);
+
+        static inline std::mutex s_mutex;
+        static inline std::atomic<QueueEngine*> s_engines[LoggerConstants::MAX_CRASH_ENGINES] = {};
+        static inline size_t s_registered = 0;
+        static inline struct sigaction s_previous[SIGNAL_COUNT] = {};
+        static inline char* s_buffer = nullptr;
+        static inline std::atomic<bool> s_draining{false};
+    };
+
+    /**
+     * @brief Async-signal-safe line writer over a caller-owned buffer
+     */
+    class EmergencyWriter {
+    public:
+        EmergencyWriter(int fd, char* buffer, size_t capacity, long utcOffset)
+            : m_fd(fd), m_buffer(buffer), m_capacity(capacity), m_utcOffset(utcOffset) {}
+
+        ~EmergencyWriter() { flush(); }
+
+        EmergencyWriter(const EmergencyWriter&) = delete;
+        EmergencyWriter& operator=(const EmergencyWriter&) = delete;
+
+        /**
+         * @brief Append one record in the default "[time] [level] [thread] message" layout
+         */
+        void writeRecord(const spdlog::details::log_msg& msg) {
+            auto sinceEpoch = msg.time.time_since_epoch();
+            long long millis = std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch).count()
+                               + static_cast<long long>(m_utcOffset) * 1000;
+            long long days = millis / 86400000;
+            long long dayMillis = millis % 86400000;
+            if (dayMillis < 0) {
+                dayMillis += 86400000;
+                --days;
+            }
+
+            // Civil date from days since 1970-01-01 (Howard Hinnant's algorithm)
+            days += 719468;
+            long long era = (days >= 0 ? days : days - 146096) / 146097;
+            long long dayOfEra = days - era * 146097;
+            long long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+            long long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+            long long monthIndex = (5 * dayOfYear + 2) / 153;
+            long long day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+            long long month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+            long long year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+            append("[", 1);
+            appendNumber(static_cast<unsigned long long>(year), 4);
+            append("-", 1);
+            appendNumber(static_cast<unsigned long long>(month), 2);
+            append("-", 1);
+            appendNumber(static_cast<unsigned long long>(day), 2);
+            append(" ", 1);
+            appendNumber(static_cast<unsigned long long>(dayMillis / 3600000), 2);
+            append(":", 1);
+            appendNumber(static_cast<unsigned long long>(dayMillis / 60000 % 60), 2);
+            append(":", 1);
+            appendNumber(static_cast<unsigned long long>(dayMillis / 1000 % 60), 2);
+            append(".", 1);
+            appendNumber(static_cast<unsigned long long>(dayMillis % 1000), 3);
+            append("] [", 3);
+            auto levelName = spdlog::level::to_string_view(msg.level);
+            append(levelName.data(), levelName.size());
+            append("] [", 3);
+            appendNumber(msg.thread_id, 1);
+            append("] ", 2);
+            append(msg.payload.data(), msg.payload.size());
+            append("\n", 1);
+        }
+
+        void flush() {
+            writeAll(m_buffer, m_used);
+            m_used = 0;
+        }
+
+    private:
+        void append(const char* data, size_t length) {
+            if (m_used + length > m_capacity) {
+                flush();
+                if (length > m_capacity) {
+                    writeAll(data, length);
+                    return;
+                }
+            }
+            std::memcpy(m_buffer + m_used, data, length);
+            m_used += length;
+        }
+
+        void appendNumber(unsigned long long value, int minDigits) {
+            char digits[24];
+            int count = 0;
+            do {
+                digits[count++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value > 0 && count < 20);
+            while (count < minDigits) {
+                digits[count++] = '0';
+            }
+            char ordered[24];
+            for (int i = 0; i < count; ++i) {
+                ordered[i] = digits[count - 1 - i];
+            }
+            append(ordered, static_cast<size_t>(count));
+        }
+
+        void writeAll(const char* data, size_t length) {
+            while (length > 0) {
+                ssize_t written = ::write(m_fd, data, length);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return;
+                }
+                data += written;
+                length -= static_cast<size_t>(written);
+            }
+        }
+
+        int m_fd;
+        char* m_buffer;
+        size_t m_capacity;
+        size_t m_used = 0;
+        long m_utcOffset;
+    };
+
+    /**
+     * @brief Sharded queue engine with one or more backend workers
+     *
+     * Records at or above the priority level go to a small priority lane that
+     * worker 0 always drains before its normal shards, so an ERROR or FATAL is
+     * never stuck behind a backlog of INFO records. The file is therefore not
+     * in call order: a priority record is written ahead of records logged
+     * before it, even by the same thread. Writing it in sequence would make it
+     * wait out that backlog again, so no sequence is carried between the
+     * lanes; each lane is FIFO on its own. Everything else goes to one
+     * of K normal shards chosen by producer thread, so producers on different
+     * threads rarely contend on the same queue. Shard i is owned by worker
+     * i % W; a thread always posts to the same shard, which keeps its records
+     * in order, and every record keeps its capture timestamp and thread id.
+     *
+     * With a commit window, flushes that records ask for and flush barriers
+     * are group committed: a worker that still has records queued keeps
+     * writing and flushes once, when its lanes run dry or the window since
+     * the first request has passed. A worker never sleeps with a flush owed,
+     * so a flushed record is in the file before the process can go quiet.
+     *
+     * A crash-safe engine additionally flushes its sinks whenever the queue runs
+     * empty and can be parked by CrashHandler, so that after a fatal signal every
+     * record is either already in the file or still in a lane.
+     */
+    class QueueEngine {
+    public:
+        QueueEngine(RecordProcessor& processor, const EngineOptions& options)
+            : m_processor(processor),
+              m_priorityLevel(options.priorityLevel),
+              m_priorityLane(makePriorityLane(options)),
+              m_numa(options.numa),
+              m_releaseAfter(options.releaseAfter),
+              m_commitWindow(options.commitWindow),
+              m_slab(options.slab),
+              m_manual(options.manual),
+              m_crashSafe(options.crashHandler),
+              m_crashLogPath(options.crashLogPath) {
+            const NumaTopology& topology = NumaTopology::system();
+            size_t shards = m_numa ? topology.nodes.size() : std::max<size_t>(options.shards, 1);
+            m_shards.resize(shards);
+            for (size_t i = 0; i < shards; ++i) {
+                if (m_numa) {
+                    // Built on a thread running on the node so that first touch
+                    // places the slots in node-local memory
+                    std::thread([&, i]() {
+                        topology.pinToNode(i);
+                        m_shards[i] = makeQueue(options, shards);
+                    }).join();
+                } else {
+                    m_shards[i] = makeQueue(options, shards);
+                }
+            }
+            if (options.autoTune && !options.byteRing) {
+                m_load = std::make_unique<ShardLoad[]>(shards);
+                m_resizable = !options.lockFree;
+                m_minShardSize = minShardSize(options, shards);
+                m_maxShardSize = maxShardSize(options, shards);
+                m_rates.reserve(LoggerConstants::AUTO_TUNE_HISTORY);
+            }
+
+            std::time_t now = std::time(nullptr);
+            std::tm local{};
+            localtime_r(&now, &local);
+            m_utcOffset = local.tm_gmtoff;
+
+            if (m_manual) {
+                m_pumpLanes.priority = m_priorityLane.get();
+                for (size_t i = 0; i < shards; ++i) {
+                    m_pumpLanes.shards.push_back(m_shards[i].get());
+                    m_pumpLanes.indices.push_back(i);
+                }
+                m_pumpLanes.quietWindows.assign(shards, 0);
+                m_pumpLanes.windowStart = std::chrono::steady_clock::now();
+                m_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            }
+
+            size_t workers = m_manual ? 0 : m_numa ? shards : std::min(std::max<size_t>(options.workers, 1), shards);
+            m_workerHandles.resize(workers);
+            for (size_t w = 0; w < workers; ++w) {
+                m_workers.emplace_back([this, w]() { workerLoop(w); });
+                m_workerHandles[w] = m_workers.back().native_handle();
+            }
+            if (m_crashSafe) {
+                CrashHandler::registerEngine(this);
+            }
+        }
+
+        ~QueueEngine() {
+            stop();
+            if (m_eventFd >= 0) {
+                ::close(m_eventFd);
+            }
+        }
+
+        QueueEngine(const QueueEngine&) = delete;
+        QueueEngine& operator=(const QueueEngine&) = delete;
+
+        /**
+         * @brief Queue a copy of the record, blocking while its lane is full
+         */
+        void post(const spdlog::details::log_msg& msg) {
+            PostGuard guard(m_posting);
+            if (m_stopping.load(std::memory_order_seq_cst)) {
+                return;
+            }
+            bool priority = msg.level >= m_priorityLevel;
+            size_t shard = priority ? 0 : (m_numa ? producerNode() : producerSlot()) % m_shards.size();
+            RecordQueue& lane = priority ? *m_priorityLane : *m_shards[shard];
+            bool waited = false;
+            if (lane.storesMessages()) {
+                waited = enqueue([&]() { return lane.tryPushMessage(msg); });
+            } else {
+                bool spills = msg.logger_name.size() + msg.payload.size() > LoggerConstants::INLINE_RECORD_SIZE;
+                QueuedRecord record = (m_slab && spills) ? QueuedRecord(msg, PayloadSlab::local()) : QueuedRecord(msg);
+                waited = enqueue([&]() { return lane.tryPush(std::move(record)); });
+            }
+            if (m_load && !priority) {
+                noteLoad(m_load[shard], lane, waited);
+            }
+        }
+
+        /**
+         * @brief Queue a producer's batch as one entry, blocking while its lane is full
+         *
+         * The batch goes to the producer's shard, or to the priority lane when
+         * any of its lines is at or above the priority level.
+         */
+        void postBatch(std::shared_ptr<RecordBatch> batch) {
+            PostGuard guard(m_posting);
+            if (m_stopping.load(std::memory_order_seq_cst) || batch->messages.empty()) {
+                batch->release();
+                return;
+            }
+            batch->seal();
+            bool priority = batch->maxLevel >= m_priorityLevel;
+            size_t shard = priority ? 0 : (m_numa ? producerNode() : producerSlot()) % m_shards.size();
+            RecordQueue& lane = priority ? *m_priorityLane : *m_shards[shard];
+            bool waited = false;
+            if (lane.storesMessages()) {
+                const auto* messages = batch->messages.data();
+                size_t count = batch->messages.size();
+                // A batch larger than the ring goes in piece by piece, waking
+                // the worker after each so that it can make room for the next
+                for (size_t pushed = 0; pushed < count;) {
+                    waited = enqueue([&]() {
+                        size_t added = lane.tryPushMessages(messages + pushed, count - pushed);
+                        pushed += added;
+                        return added > 0;
+                    }) || waited;
+                }
+                batch->release();
+            } else {
+                QueuedRecord record;
+                record.kind = RecordKind::BATCH;
+                record.batch = std::move(batch);
+                waited = enqueue([&]() { return lane.tryPush(std::move(record)); });
+            }
+            if (m_load && !priority) {
+                noteLoad(m_load[shard], lane, waited);
+            }
+        }
+
+        /**
+         * @brief Wait until every record queued so far has been written and flushed
+         */
+        void flush() {
+            if (isWorkerThread()) {
+                m_processor.processFlush();
+                return;
+            }
+            auto done = flushAsync(nullptr);
+            if (m_manual) {
+                // Nobody else may be pumping: write up to the barrier on this thread
+                while (done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    if (poll(LoggerConstants::DEFAULT_POLL_BUDGET) == 0) {
+                        std::this_thread::yield();
+                    }
+                }
+                return;
+            }
+            done.wait();
+        }
+
+        /**
+         * @brief Write queued entries on the calling thread (manual mode only)
+         * @param budget Maximum number of queue entries; a batch counts once
+         * @return Entries processed
+         */
+        size_t poll(size_t budget) {
+            if (!m_manual) {
+                return 0;
+            }
+            std::lock_guard<std::mutex> lock(m_pumpMutex);
+            m_pumpOwner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+            // Cleared before draining: a record that arrives after the last pop
+            // below finds the flag down and signals the eventfd again
+            m_signalled.store(false, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            uint64_t count = 0;
+            ssize_t drained = ::read(m_eventFd, &count, sizeof(count));
+            (void)drained;
+
+            WorkerLanes& lanes = m_pumpLanes;
+            size_t processed = 0;
+            while (processed < budget && lanes.pop(m_pumpRecord)) {
+                if (m_stopping.load(std::memory_order_acquire) && std::chrono::steady_clock::now() >= m_stopDeadline) {
+                    abandon(m_pumpRecord);
+                } else {
+                    process(m_pumpRecord, 0, lanes);
+                }
+                ++processed;
+                commitIfDue(lanes);
+                if (m_load && ++lanes.sinceCheck >= LoggerConstants::AUTO_TUNE_CHECK_RECORDS) {
+                    lanes.sinceCheck = 0;
+                    auto now = std::chrono::steady_clock::now();
+                    if (now - lanes.windowStart >= std::chrono::milliseconds(LoggerConstants::AUTO_TUNE_INTERVAL_MS)) {
+                        tune(lanes, now);
+                    }
+                }
+            }
+            if (!lanes.empty()) {
+                signal();
+            } else {
+                commit(lanes);
+            }
+            m_pumpOwner.store(std::thread::id(), std::memory_order_relaxed);
+            return processed;
+        }
+
+        /**
+         * @brief Descriptor that reads as ready while records wait for poll(); -1 unless manual
+         */
+        [[nodiscard]] int eventFd() const { return m_eventFd; }
+
+        /**
+         * @brief Queue a flush barrier behind every record queued so far
+         * @param callback Optional function run on a worker once the sinks are flushed
+         * @return Future that becomes ready when the barrier has been processed
+         *
+         * The barrier goes into every shard; the worker that processes the last
+         * copy flushes the sinks and completes it.
+         */
+        std::future<void> flushAsync(std::function<void()> callback) {
+            auto barrier = std::make_shared<FlushBarrier>();
+            barrier->callback = std::move(callback);
+            barrier->remaining.store(m_shards.size(), std::memory_order_relaxed);
+            auto done = barrier->done.get_future();
+            PostGuard guard(m_posting);
+            if (m_stopping.load(std::memory_order_seq_cst)) {
+                barrier->complete();
+                return done;
+            }
+            for (auto& shard : m_shards) {
+                QueuedRecord record;
+                record.kind = RecordKind::FLUSH;
+                record.barrier = barrier;
+                enqueue([&]() { return shard->tryPush(std::move(record)); });
+            }
+            return done;
+        }
+
+        /**
+         * @brief Drain every lane and join the workers
+         * @param deadline Time allowed for writing queued records; the rest are dropped
+         * @return Number of queued records abandoned when the deadline expired
+         */
+        size_t stop(std::chrono::milliseconds deadline = std::chrono::milliseconds::max()) {
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+                if (m_stopping.load(std::memory_order_relaxed)) {
+                    return 0;
+                }
+                auto now = std::chrono::steady_clock::now();
+                m_stopDeadline = (deadline >= std::chrono::hours(24 * 365))
+                    ? std::chrono::steady_clock::time_point::max()
+                    : now + deadline;
+                m_stopping.store(true, std::memory_order_seq_cst);
+            }
+            if (m_crashSafe) {
+                CrashHandler::unregisterEngine(this);
+            }
+            m_workAvailable.notify_all();
+            for (auto& worker : m_workers) {
+                if (worker.joinable()) {
+                    worker.join();
+                }
+            }
+            if (m_manual) {
+                // poll() writes until the deadline and abandons the rest without
+                // writing it, so this ends soon after the deadline however much
+                // is queued. Producers still between their check and their push
+                // are waited for, so that nothing arrives after the last poll.
+                for (;;) {
+                    bool settled = !posting();
+                    if (poll(LoggerConstants::DEFAULT_POLL_BUDGET) == 0) {
+                        if (settled) {
+                            break;
+                        }
+                        std::this_thread::yield();
+                    }
+                }
+                commit(m_pumpLanes);
+                m_processor.processFlush();
+            }
+            size_t abandoned = m_abandoned.load(std::memory_order_relaxed);
+            if (abandoned > 0) {
+                std::string notice = "Shutdown deadline reached, " + std::to_string(abandoned) +
+                                     " queued records abandoned";
+                m_processor.processLog(spdlog::details::log_msg(spdlog::string_view_t{}, spdlog::level::warn, notice), 0);
+                m_processor.processFlush();
+            }
+            return abandoned;
+        }
+
+        [[nodiscard]] size_t pending() const {
+            size_t total = m_priorityLane->size();
+            for (const auto& shard : m_shards) {
+                total += shard->size();
+            }
+            return total;
+        }
+
+        [[nodiscard]] size_t shardCount() const { return m_shards.size(); }
+        [[nodiscard]] size_t workerCount() const { return m_workers.size(); }
+
+        /**
+         * @brief Burst statistics and the static size they suggest
+         * @note Only the capacity is filled in unless EngineOptions::autoTune is set
+         */
+        [[nodiscard]] QueueStats stats() const {
+            QueueStats stats;
+            for (const auto& shard : m_shards) {
+                stats.capacity += shard->capacity();
+            }
+            if (!m_load) {
+                stats.recommendedQueueSize = stats.capacity;
+                return stats;
+            }
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            size_t peak = m_peakDepth;
+            uint64_t blocked = m_blockedTotal;
+            for (size_t i = 0; i < m_shards.size(); ++i) {
+                peak = std::max(peak, m_load[i].peak.load(std::memory_order_relaxed));
+                blocked += m_load[i].blocked.load(std::memory_order_relaxed);
+            }
+            stats.highWaterMark = peak;
+            stats.blockedPushes = blocked;
+            stats.resizes = m_resizes;
+            stats.arrivalRatePeak = m_ratePeak;
+            if (!m_rates.empty()) {
+                std::vector<double> rates(m_rates);
+                std::sort(rates.begin(), rates.end());
+                stats.arrivalRateMedian = rates[rates.size() / 2];
+                stats.arrivalRateP99 = rates[(rates.size() - 1) * 99 / 100];
+            }
+            // A quarter of headroom over the deepest burst; the upper bound when
+            // producers blocked even at the largest allowed size
+            size_t perShard = m_saturated ? m_maxShardSize : std::max<size_t>(peak + peak / 4, 1);
+            size_t rounded = 1;
+            while (rounded < perShard) {
+                rounded <<= 1;
+            }
+            stats.recommendedQueueSize = std::clamp(rounded, m_minShardSize, m_maxShardSize) * m_shards.size();
+            return stats;
+        }
+
+        /**
+         * @brief Stop the workers before emergencyDrain(); they stay parked
+         * @note Runs inside a signal handler: only async-signal-safe calls
+         */
+        void emergencyPark() {
+            m_crashing.store(true, std::memory_order_seq_cst);
+            // A worker that crashed itself will never park
+            int idleNeeded = static_cast<int>(m_workerHandles.size());
+            for (const auto& handle : m_workerHandles) {
+                if (pthread_equal(pthread_self(), handle)) {
+                    --idleNeeded;
+                }
+            }
+            struct timespec pause = {0, 1000000};
+            for (int waited = 0; waited < LoggerConstants::CRASH_PARK_TIMEOUT_MS; ++waited) {
+                if (m_parkedWorkers.load(std::memory_order_seq_cst) +
+                    m_waitingWorkers.load(std::memory_order_seq_cst) >= idleNeeded) {
+                    break;
+                }
+                nanosleep(&pause, nullptr);
+            }
+        }
+
+        /**
+         * @brief Append queued records to the log file; call emergencyPark() first
+         * @note Runs inside a signal handler: only async-signal-safe calls
+         */
+        void emergencyDrain(char* buffer, size_t capacity) {
+            int fd = STDOUT_FILENO;
+            if (!m_crashLogPath.empty()) {
+                fd = ::open(m_crashLogPath.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+                if (fd < 0) {
+                    return;
+                }
+            }
+            {
+                EmergencyWriter writer(fd, buffer, capacity, m_utcOffset);
+                auto visit = [](const spdlog::details::log_msg& msg, void* context) {
+                    static_cast<EmergencyWriter*>(context)->writeRecord(msg);
+                };
+                m_priorityLane->visitPending(visit, &writer);
+                for (const auto& shard : m_shards) {
+                    shard->visitPending(visit, &writer);
+                }
+            }
+            if (fd != STDOUT_FILENO) {
+                ::close(fd);
+            }
+        }
+
+    private:
+        static std::unique_ptr<RecordQueue> makeQueue(const EngineOptions& options, size_t shards) {
+            if (options.byteRing) {
+                return std::make_unique<ByteRingQueue>(options.queueBytes / shards, options.releaseAfter.count() == 0,
+                                                       options.pages);
+            }
+            size_t capacity = std::max<size_t>(options.queueSize / shards, 1);
+            if (options.lockFree) {
+                return std::make_unique<LockFreeQueue>(capacity, options.pages);
+            }
+            if (options.autoTune) {
+                capacity = std::clamp(capacity, minShardSize(options, shards), maxShardSize(options, shards));
+            }
+            return std::make_unique<RingQueue>(capacity, options.releaseAfter.count() == 0, options.pages);
+        }
+
+        static size_t minShardSize(const EngineOptions& options, size_t shards) {
+            return std::max<size_t>(options.autoTuneMinSize / shards, 1);
+        }
+
+        static size_t maxShardSize(const EngineOptions& options, size_t shards) {
+            return std::max(options.autoTuneMaxBytes / sizeof(QueuedRecord) / shards, minShardSize(options, shards));
+        }
+
+        static std::unique_ptr<RecordQueue> makePriorityLane(const EngineOptions& options) {
+            if (options.byteRing) {
+                return std::make_unique<ByteRingQueue>(options.queueBytes / LoggerConstants::PRIORITY_QUEUE_BYTES_DIVISOR,
+                                                       options.releaseAfter.count() == 0, options.pages);
+            }
+            return std::make_unique<RingQueue>(options.priorityQueueSize, options.releaseAfter.count() == 0,
+                                               options.pages);
+        }
+
+        /**
+         * @brief Small per-thread number used to spread producers over the shards
+         *
+         * Handed out in thread start order rather than hashed from std::thread::id,
+         * whose low bits are mostly zero on glibc.
+         */
+        static size_t producerSlot() {
+            static std::atomic<size_t> s_nextSlot{0};
+            thread_local size_t slot = s_nextSlot.fetch_add(1, std::memory_order_relaxed);
+            return slot;
+        }
+
+        /**
+         * @brief Node the calling thread was on when it first logged
+         *
+         * Sticky so that a thread's records stay in one shard, and so in order,
+         * even if the scheduler later moves it; pin producers on NUMA hosts.
+         */
+        static size_t producerNode() {
+            thread_local size_t node = NumaTopology::system().currentNode();
+            return node;
+        }
+
+        bool isWorkerThread() const {
+            auto self = std::this_thread::get_id();
+            if (m_pumpOwner.load(std::memory_order_relaxed) == self) {
+                return true;
+            }
+            for (const auto& worker : m_workers) {
+                if (worker.get_id() == self) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Producers of one producer slot between their stopping check and their push
+         *
+         * One counter per cache line, so that threads in different slots
+         * never write the same line on the way in.
+         */
+        struct alignas(LoggerConstants::CACHE_LINE_SIZE) PostingCount {
+            std::atomic<size_t> count{0};
+        };
+
+        /**
+         * @brief Counts a producer from its stopping check until its push is done
+         *
+         * Workers exit only while every count is zero, so a record that passed
+         * the check is always written or counted as abandoned. The increment
+         * and the stopping flag are both seq_cst: a producer whose increment
+         * comes after a worker read the counter also sees the flag and backs out.
+         */
+        struct PostGuard {
+            explicit PostGuard(PostingCount* posting)
+                : count(posting[producerSlot() % LoggerConstants::POSTING_SLOTS].count) {
+                count.fetch_add(1, std::memory_order_seq_cst);
+            }
+            ~PostGuard() { count.fetch_sub(1, std::memory_order_seq_cst); }
+            PostGuard(const PostGuard&) = delete;
+            PostGuard& operator=(const PostGuard&) = delete;
+
+            std::atomic<size_t>& count;
+        };
+
+        /**
+         * @brief True while a producer that passed its stopping check has not finished its push
+         */
+        bool posting() const {
+            for (const auto& slot : m_posting) {
+                if (slot.count.load(std::memory_order_seq_cst) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Run tryPush until it succeeds, sleeping while the lane is full
+         * @return True when the lane was full and the caller had to wait
+         */
+        template<typename TryPush>
+        bool enqueue(TryPush&& tryPush) {
+            bool waited = false;
+            if (!tryPush()) {
+                waited = true;
+                if (m_manual) {
+                    // No worker will make room: write queued entries on this thread
+                    while (!tryPush()) {
+                        if (poll(LoggerConstants::PUMP_ON_FULL_BUDGET) == 0) {
+                            std::this_thread::yield();
+                        }
+                    }
+                } else {
+                    std::unique_lock<std::mutex> lock(m_waitMutex);
+                    m_spaceWaiters.fetch_add(1, std::memory_order_seq_cst);
+                    while (!tryPush()) {
+                        m_spaceAvailable.wait_for(lock, std::chrono::milliseconds(10));
+                    }
+                    m_spaceWaiters.fetch_sub(1, std::memory_order_seq_cst);
+                }
+            }
+            // Pairs with the fence in workerLoop: either a worker sees this
+            // record before sleeping or we see it waiting and wake it
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_waitingWorkers.load(std::memory_order_seq_cst) > 0) {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+                m_workAvailable.notify_all();
+            }
+            if (m_eventFd >= 0) {
+                signal();
+            }
+            return waited;
+        }
+
+        /**
+         * @brief Make the eventfd readable, once per poll() cycle
+         */
+        void signal() {
+            if (!m_signalled.load(std::memory_order_seq_cst) && !m_signalled.exchange(true, std::memory_order_seq_cst)) {
+                uint64_t one = 1;
+                ssize_t written = ::write(m_eventFd, &one, sizeof(one));
+                (void)written;
+            }
+        }
+
+        /**
+         * @brief Producer-side load of one shard during the current tuning window
+         */
+        struct alignas(LoggerConstants::CACHE_LINE_SIZE) ShardLoad {
+            std::atomic<size_t> peak{0};       ///< Deepest the shard got; raised by producers
+            std::atomic<uint64_t> blocked{0};  ///< Pushes that found the shard full
+        };
+
+        static void noteLoad(ShardLoad& load, const RecordQueue& lane, bool waited) {
+            size_t depth = lane.size();
+            size_t peak = load.peak.load(std::memory_order_relaxed);
+            while (depth > peak && !load.peak.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+            }
+            if (waited) {
+                load.blocked.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Lanes a single worker drains: its shards, plus the priority lane for worker 0
+         */
+        struct WorkerLanes {
+            RecordQueue* priority = nullptr;
+            std::vector<RecordQueue*> shards;
+            size_t next = 0;
+
+            // Auto-tuning window
+            std::vector<size_t> indices;       ///< Engine index of each shard
+            std::vector<size_t> quietWindows;  ///< Consecutive windows each shard stayed under a quarter full
+            size_t popped = 0;                 ///< Shard records popped in the window
+            size_t windowDepth = 0;            ///< Shard records queued when the window started
+            std::chrono::steady_clock::time_point windowStart;
+            size_t sinceCheck = 0;
+
+            RecordQueue* unfinished = nullptr;  ///< Lane whose front holds the rest of a stored batch
+
+            // Group commit
+            std::chrono::steady_clock::time_point commitDue = std::chrono::steady_clock::time_point::max();
+            std::vector<std::shared_ptr<FlushBarrier>> committing;  ///< Completed by the next commit
+
+            bool empty() const {
+                if (priority != nullptr && !priority->empty()) {
+                    return false;
+                }
+                for (const auto* shard : shards) {
+                    if (!shard->empty()) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void releaseMemory() {
+                if (priority != nullptr) {
+                    priority->releaseMemory();
+                }
+                for (auto* shard : shards) {
+                    shard->releaseMemory();
+                }
+            }
+
+            bool pop(QueuedRecord& record) {
+                if (unfinished != nullptr) {
+                    // Finish a batch stored line by line before looking at other lanes
+                    RecordQueue* lane = std::exchange(unfinished, nullptr);
+                    if (lane->tryPop(record)) {
+                        if (lane != priority) {
+                            ++popped;
+                        }
+                        if (record.batchContinues) {
+                            unfinished = lane;
+                        }
+                        return true;
+                    }
+                }
+                if (priority != nullptr && !priority->empty() && priority->tryPop(record)) {
+                    if (record.batchContinues) {
+                        unfinished = priority;
+                    }
+                    return true;
+                }
+                for (size_t i = 0; i < shards.size(); ++i) {
+                    RecordQueue* shard = shards[next];
+                    next = (next + 1 == shards.size()) ? 0 : next + 1;
+                    if (shard->tryPop(record)) {
+                        ++popped;
+                        if (record.batchContinues) {
+                            unfinished = shard;
+                        }
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+
+        void workerLoop(size_t index) {
+            if (m_numa) {
+                NumaTopology::system().pinToNode(index);
+            }
+            WorkerLanes lanes;
+            if (index == 0) {
+                lanes.priority = m_priorityLane.get();
+            }
+            size_t workers = m_workerHandles.size();
+            for (size_t i = index; i < m_shards.size(); i += workers) {
+                lanes.shards.push_back(m_shards[i].get());
+                lanes.indices.push_back(i);
+            }
+            lanes.quietWindows.assign(lanes.shards.size(), 0);
+            lanes.windowStart = std::chrono::steady_clock::now();
+            const auto tuneInterval = std::chrono::milliseconds(LoggerConstants::AUTO_TUNE_INTERVAL_MS);
+
+            QueuedRecord record;
+            bool unflushed = false;
+            bool released = (m_releaseAfter.count() == 0);
+            auto idleSince = std::chrono::steady_clock::time_point::max();
+            while (true) {
+                if (m_crashSafe && m_crashing.load(std::memory_order_seq_cst)) {
+                    parkForCrash();
+                }
+                if (lanes.pop(record)) {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (m_spaceWaiters.load(std::memory_order_seq_cst) > 0) {
+                        std::lock_guard<std::mutex> lock(m_waitMutex);
+                        m_spaceAvailable.notify_all();
+                    }
+                    if (m_stopping.load(std::memory_order_acquire) &&
+                        std::chrono::steady_clock::now() >= m_stopDeadline) {
+                        abandon(record);
+                        continue;
+                    }
+                    process(record, index, lanes);
+                    commitIfDue(lanes);
+                    unflushed = true;
+                    released = (m_releaseAfter.count() == 0);
+                    idleSince = std::chrono::steady_clock::time_point::max();
+                    if (m_load && ++lanes.sinceCheck >= LoggerConstants::AUTO_TUNE_CHECK_RECORDS) {
+                        lanes.sinceCheck = 0;
+                        auto now = std::chrono::steady_clock::now();
+                        if (now - lanes.windowStart >= tuneInterval) {
+                            tune(lanes, now);
+                        }
+                    }
+                    continue;
+                }
+
+                if (lanes.commitDue != std::chrono::steady_clock::time_point::max()) {
+                    // Out of records: the owed flush must not wait out the window
+                    commit(lanes);
+                    unflushed = false;
+                    continue;
+                }
+
+                if (m_crashSafe && unflushed) {
+                    // Keep nothing in stdio buffers while the worker sleeps
+                    m_processor.processFlush();
+                    unflushed = false;
+                    continue;
+                }
+
+                if (idleSince == std::chrono::steady_clock::time_point::max()) {
+                    idleSince = std::chrono::steady_clock::now();
+                }
+                std::unique_lock<std::mutex> lock(m_waitMutex);
+                m_waitingWorkers.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                bool tuneDue = false;
+                while (lanes.empty() && !m_stopping.load(std::memory_order_relaxed)) {
+                    auto wake = released ? std::chrono::steady_clock::time_point::max() : idleSince + m_releaseAfter;
+                    if (m_load && !tuningSettled(lanes)) {
+                        wake = std::min(wake, lanes.windowStart + tuneInterval);
+                    }
+                    if (wake == std::chrono::steady_clock::time_point::max()) {
+                        m_workAvailable.wait(lock);
+                        continue;
+                    }
+                    if (m_workAvailable.wait_until(lock, wake) == std::cv_status::no_timeout || !lanes.empty()) {
+                        continue;
+                    }
+                    auto now = std::chrono::steady_clock::now();
+                    if (m_load && now - lanes.windowStart >= tuneInterval) {
+                        // Resizing must not run while counted as waiting, or a
+                        // crash drain could walk a slot array being replaced
+                        tuneDue = true;
+                        break;
+                    }
+                    if (!released && now >= idleSince + m_releaseAfter) {
+                        // Quiet period over: hand the burst's memory back
+                        lock.unlock();
+                        lanes.releaseMemory();
+                        record = QueuedRecord();
+                        trimHeap();
+                        lock.lock();
+                        released = true;
+                    }
+                }
+                m_waitingWorkers.fetch_sub(1, std::memory_order_relaxed);
+                if (m_stopping.load(std::memory_order_relaxed) && lanes.empty()) {
+                    // A producer that passed its stopping check may still push
+                    if (!posting() && lanes.empty()) {
+                        break;
+                    }
+                    lock.unlock();
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (tuneDue) {
+                    lock.unlock();
+                    tune(lanes, std::chrono::steady_clock::now());
+                }
+            }
+            commit(lanes);
+            m_processor.processFlush();
+        }
+
+        /**
+         * @brief True when an idle worker has no window left to close and nothing to shrink
+         */
+        bool tuningSettled(const WorkerLanes& lanes) const {
+            if (lanes.popped > 0) {
+                return false;
+            }
+            if (!m_resizable) {
+                return true;
+            }
+            for (const auto* shard : lanes.shards) {
+                if (shard->capacity() > m_minShardSize) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Close the worker's statistics window and resize its shards
+         *
+         * A shard that filled up or made a producer wait doubles, up to the
+         * memory bound. One that stayed under a quarter full for
+         * AUTO_TUNE_SHRINK_WINDOWS windows in a row halves, down to the minimum.
+         */
+        void tune(WorkerLanes& lanes, std::chrono::steady_clock::time_point now) {
+            double seconds = std::chrono::duration<double>(now - lanes.windowStart).count();
+            size_t depth = 0;
+            size_t windowPeak = 0;
+            uint64_t blocked = 0;
+            uint64_t resizes = 0;
+            bool saturated = false;
+            for (size_t i = 0; i < lanes.shards.size(); ++i) {
+                RecordQueue& shard = *lanes.shards[i];
+                ShardLoad& load = m_load[lanes.indices[i]];
+                size_t queued = shard.size();
+                depth += queued;
+                size_t peak = std::max(load.peak.exchange(queued, std::memory_order_relaxed), queued);
+                uint64_t full = load.blocked.exchange(0, std::memory_order_relaxed);
+                windowPeak = std::max(windowPeak, peak);
+                blocked += full;
+
+                size_t capacity = shard.capacity();
+                size_t target = capacity;
+                if (full > 0 || peak >= capacity) {
+                    lanes.quietWindows[i] = 0;
+                    target = std::min(capacity * 2, m_maxShardSize);
+                    saturated = saturated || (full > 0 && capacity >= m_maxShardSize);
+                } else if (peak > capacity / 4) {
+                    lanes.quietWindows[i] = 0;
+                } else if (++lanes.quietWindows[i] >= LoggerConstants::AUTO_TUNE_SHRINK_WINDOWS) {
+                    lanes.quietWindows[i] = 0;
+                    target = std::max(capacity / 2, m_minShardSize);
+                }
+                if (m_resizable && target != capacity && shard.resize(target)) {
+                    ++resizes;
+                }
+            }
+            // Whatever did not leave the shards in this window is still queued
+            size_t arrivals = (lanes.popped + depth > lanes.windowDepth) ? lanes.popped + depth - lanes.windowDepth : 0;
+            double rate = (seconds > 0.0) ? static_cast<double>(arrivals) / seconds / lanes.shards.size() : 0.0;
+            lanes.popped = 0;
+            lanes.windowDepth = depth;
+            lanes.windowStart = now;
+
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_peakDepth = std::max(m_peakDepth, windowPeak);
+            m_blockedTotal += blocked;
+            m_resizes += resizes;
+            m_saturated = m_saturated || saturated;
+            if (arrivals > 0) {
+                if (m_rates.size() < LoggerConstants::AUTO_TUNE_HISTORY) {
+                    m_rates.push_back(rate);
+                } else {
+                    m_rates[m_rateNext] = rate;
+                }
+                m_rateNext = (m_rateNext + 1) % LoggerConstants::AUTO_TUNE_HISTORY;
+                m_ratePeak = std::max(m_ratePeak, rate);
+            }
+        }
+
+        /**
+         * @brief Give freed payload buffers back to the OS where the allocator allows it
+         */
+        static void trimHeap() {
+#if defined(__GLIBC__)
+            malloc_trim(0);
+#endif
+        }
+
+        void abandon(QueuedRecord& record) {
+            if (record.kind == RecordKind::FLUSH) {
+                if (record.barrier->arrive()) {
+                    record.barrier->complete();
+                }
+                record.barrier.reset();
+                record.kind = RecordKind::LOG;
+                return;
+            }
+            if (record.kind == RecordKind::BATCH) {
+                m_abandoned.fetch_add(record.batch->messages.size(), std::memory_order_relaxed);
+                releaseBatch(record);
+                return;
+            }
+            m_abandoned.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void releaseBatch(QueuedRecord& record) {
+            record.batch->release();
+            record.batch.reset();
+            record.kind = RecordKind::LOG;
+        }
+
+        void process(QueuedRecord& record, size_t worker, WorkerLanes& lanes) {
+            if (record.kind == RecordKind::FLUSH) {
+                if (record.barrier->arrive()) {
+                    requestCommit(lanes, std::move(record.barrier));
+                }
+                record.barrier.reset();
+                record.kind = RecordKind::LOG;
+                return;
+            }
+            if (record.kind == RecordKind::BATCH) {
+                bool flush = false;
+                for (const auto& msg : record.batch->messages) {
+                    flush = m_processor.processLog(msg, worker) || flush;
+                }
+                releaseBatch(record);
+                if (flush) {
+                    requestCommit(lanes, nullptr);
+                }
+                return;
+            }
+            if (m_processor.processLog(record, worker)) {
+                requestCommit(lanes, nullptr);
+            }
+        }
+
+        /**
+         * @brief Owe a flush: done at once without a window, otherwise by commit()
+         * @param barrier Completed once the flush is done; may be null
+         */
+        void requestCommit(WorkerLanes& lanes, std::shared_ptr<FlushBarrier> barrier) {
+            if (barrier) {
+                lanes.committing.push_back(std::move(barrier));
+            }
+            if (lanes.commitDue == std::chrono::steady_clock::time_point::max()) {
+                lanes.commitDue = std::chrono::steady_clock::now() + m_commitWindow;
+            }
+            if (m_commitWindow.count() == 0) {
+                commit(lanes);
+            }
+        }
+
+        /**
+         * @brief Flush the sinks and complete the barriers waiting for it, if a flush is owed
+         */
+        void commit(WorkerLanes& lanes) {
+            if (lanes.commitDue == std::chrono::steady_clock::time_point::max()) {
+                return;
+            }
+            lanes.commitDue = std::chrono::steady_clock::time_point::max();
+            m_processor.processFlush();
+            for (auto& barrier : lanes.committing) {
+                barrier->complete();
+            }
+            lanes.committing.clear();
+        }
+
+        void commitIfDue(WorkerLanes& lanes) {
+            if (lanes.commitDue != std::chrono::steady_clock::time_point::max() &&
+                std::chrono::steady_clock::now() >= lanes.commitDue) {
+                commit(lanes);
+            }
+        }
+
+        [[noreturn]] void parkForCrash() {
+            m_processor.processFlush();
+            m_parkedWorkers.fetch_add(1, std::memory_order_seq_cst);
+            while (true) {
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
+        }
+
+        RecordProcessor& m_processor;
+        spdlog::level::level_enum m_priorityLevel;
+        std::vector<std::unique_ptr<RecordQueue>> m_shards;
+        std::unique_ptr<RecordQueue> m_priorityLane;
+        bool m_numa;
+        std::chrono::milliseconds m_releaseAfter;
+        std::chrono::milliseconds m_commitWindow;
+        bool m_slab;
+
+        // Manual pump; see poll()
+        bool m_manual;
+        std::mutex m_pumpMutex;
+        WorkerLanes m_pumpLanes;           ///< Every lane, drained by whoever calls poll()
+        QueuedRecord m_pumpRecord;
+        std::atomic<std::thread::id> m_pumpOwner{};
+        int m_eventFd = -1;
+        std::atomic<bool> m_signalled{false};  ///< eventfd written since the last poll()
+
+        // Auto-tuning; m_load is null when disabled
+        std::unique_ptr<ShardLoad[]> m_load;
+        bool m_resizable = false;
+        size_t m_minShardSize = 1;
+        size_t m_maxShardSize = 1;
+        mutable std::mutex m_statsMutex;
+        std::vector<double> m_rates;       ///< Recent per-window arrival rates, a ring of AUTO_TUNE_HISTORY
+        size_t m_rateNext = 0;
+        double m_ratePeak = 0.0;
+        size_t m_peakDepth = 0;
+        uint64_t m_blockedTotal = 0;
+        uint64_t m_resizes = 0;
+        bool m_saturated = false;
+
+        std::mutex m_waitMutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_spaceAvailable;
+        std::atomic<int> m_waitingWorkers{0};
+        std::atomic<int> m_spaceWaiters{0};
+        std::atomic<bool> m_stopping{false};
+        PostingCount m_posting[LoggerConstants::POSTING_SLOTS];  ///< Indexed by producerSlot()
+        std::chrono::steady_clock::time_point m_stopDeadline = std::chrono::steady_clock::time_point::max();
+        std::atomic<size_t> m_abandoned{0};
+        std::vector<std::thread> m_workers;
+
+        bool m_crashSafe;
+        std::string m_crashLogPath;
+        long m_utcOffset = 0;
+        std::vector<pthread_t> m_workerHandles;
+        std::atomic<bool> m_crashing{false};
+        std::atomic<int> m_parkedWorkers{0};
+    };
+
+    inline void CrashHandler::registerEngine(QueueEngine* engine) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (auto& slot : s_engines) {
+            QueueEngine* expected = nullptr;
+            if (slot.compare_exchange_strong(expected, engine)) {
+                break;
+            }
+        }
+        if (s_registered++ == 0) {
+            if (s_buffer == nullptr) {
+                s_buffer = new char[LoggerConstants::CRASH_BUFFER_SIZE];
+            }
+            struct sigaction action {};
+            action.sa_handler = &CrashHandler::handleSignal;
+            sigemptyset(&action.sa_mask);
+            action.sa_flags = 0;
+            for (size_t i = 0; i < SIGNAL_COUNT; ++i) {
+                sigaction(SIGNALS[i], &action, &s_previous[i]);
+            }
+        }
+    }
+
+    inline void CrashHandler::unregisterEngine(QueueEngine* engine) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (auto& slot : s_engines) {
+            QueueEngine* expected = engine;
+            if (slot.compare_exchange_strong(expected, nullptr)) {
+                break;
+            }
+        }
+        if (s_registered > 0 && --s_registered == 0) {
+            for (size_t i = 0; i < SIGNAL_COUNT; ++i) {
+                sigaction(SIGNALS[i], &s_previous[i], nullptr);
+            }
+        }
+    }
+
+    inline void CrashHandler::handleSignal(int signal) {
+        int savedErrno = errno;
+        if (s_draining.exchange(true)) {
+            // Another thread is already draining and will re-raise for us
+            struct timespec pause = {1, 0};
+            while (true) {
+                nanosleep(&pause, nullptr);
+            }
+        }
+        for (auto& slot : s_engines) {
+            QueueEngine* engine = slot.load(std::memory_order_acquire);
+            if (engine != nullptr) {
+                engine->emergencyPark();
+            }
+        }
+        // With every worker parked, mapped files have their final length
+        MappedFiles::trimAll();
+        for (auto& slot : s_engines) {
+            QueueEngine* engine = slot.load(std::memory_order_acquire);
+            if (engine != nullptr) {
+                engine->emergencyDrain(s_buffer, LoggerConstants::CRASH_BUFFER_SIZE);
+            }
+        }
+        for (size_t i = 0; i < SIGNAL_COUNT; ++i) {
+            if (SIGNALS[i] == signal) {
+                sigaction(signal, &s_previous[i], nullptr);
+            }
+        }
+        errno = savedErrno;
+        raise(signal);
+    }
+
+    /**
+     * @brief spdlog logger whose sink stage runs on a FreshLogger engine
+     *
+     * Front-end calls (including those made through Logger::getLogger()) are
+     * queued on the engine; the worker delivers them to the sinks the same way
+     * spdlog::async_logger does.
+     */
+    class EngineLogger final : public spdlog::logger, private RecordProcessor {
+    public:
+        template<typename It>
+        EngineLogger(std::string name, It begin, It end, const EngineOptions& options)
+            : spdlog::logger(std::move(name), begin, end),
+              m_workerSinks(options.workerSinks),
+              m_engine(*this, options) {}
+
+        ~EngineLogger() override { m_engine.stop(); }
+
+        [[nodiscard]] QueueEngine& engine() { return m_engine; }
+
+        /**
+         * @brief Stop the engine, writing queued records until the deadline
+         * @return Number of records abandoned
+         */
+        size_t shutdown(std::chrono::milliseconds deadline) { return m_engine.stop(deadline); }
+
+        /**
+         * @brief Queue a producer's batch as one entry; see QueueEngine::postBatch
+         */
+        void postBatch(std::shared_ptr<RecordBatch> batch) { m_engine.postBatch(std::move(batch)); }
+
+        /**
+         * @brief Queue a flush barrier; see QueueEngine::flushAsync
+         */
+        std::future<void> flushAsync(std::function<void()> callback) {
+            return m_engine.flushAsync(std::move(callback));
+        }
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override { m_engine.post(msg); }
+        void flush_() override { m_engine.flush(); }
+
+    private:
+        bool processLog(const spdlog::details::log_msg& msg, size_t worker) override {
+            for (auto& sink : sinks_) {
+                deliver(*sink, msg);
+            }
+            if (worker < m_workerSinks.size()) {
+                deliver(*m_workerSinks[worker], msg);
+            }
+            return should_flush_(msg);
+        }
+
+        void processFlush() override {
+            for (auto& sink : sinks_) {
+                flushSink(*sink);
+            }
+            for (auto& sink : m_workerSinks) {
+                flushSink(*sink);
+            }
+        }
+
+        void deliver(spdlog::sinks::sink& sink, const spdlog::details::log_msg& msg) {
+            if (sink.should_log(msg.level)) {
+                try {
+                    sink.log(msg);
+                } catch (const std::exception& ex) {
+                    err_handler_(ex.what());
+                } catch (...) {
+                    err_handler_("Unknown exception in logger");
+                }
+            }
+        }
+
+        void flushSink(spdlog::sinks::sink& sink) {
+            try {
+                sink.flush();
+            } catch (const std::exception& ex) {
+                err_handler_(ex.what());
+            } catch (...) {
+                err_handler_("Unknown exception in logger");
+            }
+        }
+
+        std::vector<spdlog::sink_ptr> m_workerSinks;  ///< Declared before m_engine: workers use it at once
+        QueueEngine m_engine;
+    };
+
+    /**
+     * @brief Completion of flushes queued on spdlog's thread pool
+     *
+     * spdlog's async_logger only queues a flush and cannot be subclassed. A
+     * second async logger on the same pool, whose only sink is a Marker,
+     * queues a flush right behind the first. The pool thread takes entries in
+     * order, so when it flushes the Marker, the logger's earlier records and
+     * its flush are done. That holds for the single-thread pool Logger
+     * creates; a pool started elsewhere with more threads gives no order.
+     */
+    class PoolFlush {
+    public:
+        PoolFlush(const std::string& name, size_t capacity)
+            : m_capacity(capacity),
+              m_marker(std::make_shared<Marker>()),
+              m_markerLogger(std::make_shared<spdlog::async_logger>(name + "_flush", m_marker, spdlog::thread_pool(),
+                                                                    spdlog::async_overflow_policy::block)) {}
+
+        /**
+         * @brief Queue a flush of logger and learn when the pool has done it
+         * @param callback Optional, run on the pool thread after the flush
+         */
+        std::future<void> flushAsync(spdlog::logger& logger, std::function<void()> callback) {
+            auto barrier = std::make_shared<FlushBarrier>();
+            barrier->callback = std::move(callback);
+            auto done = barrier->done.get_future();
+            // Markers must be queued in the order their barriers were added
+            std::lock_guard<std::mutex> lock(m_postMutex);
+            logger.flush();
+            m_marker->add(std::move(barrier));
+            m_markerLogger->flush();
+            return done;
+        }
+
+        /**
+         * @brief True when flushAsync() can queue its two entries without waiting for space
+         */
+        [[nodiscard]] bool hasRoom() const {
+            auto pool = spdlog::thread_pool();
+            return pool && pool->queue_size() + 2 <= m_capacity;
+        }
+
+    private:
+        class Marker final : public spdlog::sinks::base_sink<std::mutex> {
+        public:
+            Marker() { set_level(spdlog::level::off); }
+
+            void add(std::shared_ptr<FlushBarrier> barrier) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                m_waiting.push_back(std::move(barrier));
+            }
+
+        protected:
+            void sink_it_(const spdlog::details::log_msg&) override {}
+
+            void flush_() override {
+                if (!m_waiting.empty()) {
+                    m_waiting.front()->complete();
+                    m_waiting.pop_front();
+                }
+            }
+
+        private:
+            std::deque<std::shared_ptr<FlushBarrier>> m_waiting;
+        };
+
+        size_t m_capacity;  ///< Queue size the pool was created with
+        std::shared_ptr<Marker> m_marker;
+        std::shared_ptr<spdlog::async_logger> m_markerLogger;
+        std::mutex m_postMutex;
+    };
+
+    /**
+     * @brief Destination of a FileSink: formatted bytes, appended in order
+     */
+    class FileWriter {
+    public:
+        virtual ~FileWriter() = default;
+
+        /**
+         * @brief Open a file for appending, creating it if needed
+         * @throws spdlog::spdlog_ex when the file cannot be opened
+         */
+        virtual void open(const std::string& path, bool truncate) = 0;
+        virtual void write(const char* data, size_t size) = 0;
+        virtual void flush() = 0;  ///< Hand everything written so far to the kernel
+        virtual void close() = 0;  ///< Flush and close; no-op when not open
+        [[nodiscard]] virtual size_t size() const = 0;  ///< Bytes in the open file, including unflushed ones
+        [[nodiscard]] virtual int descriptor() const = 0;  ///< Open file for fdatasync(); -1 when closed
+    };
+
+#ifdef FRESHLOGGER_HAS_IO_URING
+    /**
+     * @brief io_uring instance driven through the raw system calls
+     *
+     * Covers what UringWriter needs and no more: one submitting thread,
+     * writes, and reaping completions.
+     */
+    class IoUring {
+    public:
+        /**
+         * @brief Whether the kernel lets this process create rings; probed once
+         */
+        static bool available() {
+            static const bool supported = []() {
+                io_uring_params params{};
+                int fd = static_cast<int>(::syscall(__NR_io_uring_setup, 1, &params));
+                if (fd < 0) {
+                    return false;
+                }
+                ::close(fd);
+                return true;
+            }();
+            return supported;
+        }
+
+        /**
+         * @throws spdlog::spdlog_ex when the ring cannot be created or mapped
+         */
+        explicit IoUring(unsigned entries) {
+            io_uring_params params{};
+            m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (m_fd < 0) {
+                spdlog::throw_spdlog_ex("io_uring_setup failed", errno);
+            }
+            m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single) {
+                m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+            }
+            m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd,
+                            IORING_OFF_SQ_RING);
+            if (m_sqRing != MAP_FAILED) {
+                m_cqRing = single ? m_sqRing
+                                  : mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                         m_fd, IORING_OFF_CQ_RING);
+            }
+            if (m_cqRing != MAP_FAILED) {
+                m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+                m_sqes = static_cast<io_uring_sqe*>(mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE,
+                                                         MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES));
+            }
+            if (m_sqRing == MAP_FAILED || m_cqRing == MAP_FAILED || m_sqes == MAP_FAILED) {
+                int error = errno;
+                release();
+                spdlog::throw_spdlog_ex("io_uring ring mapping failed", error);
+            }
+            auto* sq = static_cast<char*>(m_sqRing);
+            auto* cq = static_cast<char*>(m_cqRing);
+            m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        }
+
+        ~IoUring() { release(); }
+
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+
+        /**
+         * @brief Pin buffers for IORING_OP_WRITE_FIXED
+         * @return False when refused, typically by RLIMIT_MEMLOCK
+         */
+        bool registerBuffers(const iovec* buffers, unsigned count) {
+            return ::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+        }
+
+        /**
+         * @brief Queue a write of one buffer at an explicit file offset
+         * @param data Must stay valid until the write completes
+         * @param bufferIndex Registered buffer holding data, or -1 for a plain writev
+         */
+        void prepareWrite(int fd, const iovec& data, uint64_t offset, int bufferIndex, uint64_t userData) {
+            unsigned tail = *m_sqTail;  // Only this thread moves the tail
+            unsigned index = tail & m_sqMask;
+            io_uring_sqe& sqe = m_sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.fd = fd;
+            sqe.off = offset;
+            sqe.user_data = userData;
+            if (bufferIndex >= 0) {
+                sqe.opcode = IORING_OP_WRITE_FIXED;
+                sqe.addr = reinterpret_cast<uintptr_t>(data.iov_base);
+                sqe.len = static_cast<uint32_t>(data.iov_len);
+                sqe.buf_index = static_cast<uint16_t>(bufferIndex);
+            } else {
+                sqe.opcode = IORING_OP_WRITEV;
+                sqe.addr = reinterpret_cast<uintptr_t>(&data);
+                sqe.len = 1;
+            }
+            m_sqArray[index] = index;
+            __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+            ++m_unsubmitted;
+        }
+
+        /**
+         * @brief Submit queued writes, then wait until at least waitFor have completed
+         * @throws spdlog::spdlog_ex when the kernel rejects the call
+         */
+        void enter(unsigned waitFor) {
+            for (;;) {
+                long submitted = ::syscall(__NR_io_uring_enter, m_fd, m_unsubmitted, waitFor,
+                                           waitFor > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+                if (submitted >= 0) {
+                    m_unsubmitted -= static_cast<unsigned>(submitted);
+                    return;
+                }
+                if (errno != EINTR) {
+                    spdlog::throw_spdlog_ex("io_uring_enter failed", errno);
+                }
+            }
+        }
+
+        /**
+         * @brief Take one completion if any is ready
+         */
+        bool reap(uint64_t& userData, int& result) {
+            unsigned head = *m_cqHead;
+            if (head == __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE)) {
+                return false;
+            }
+            const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+            userData = cqe.user_data;
+            result = cqe.res;
+            __atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+    private:
+        void release() {
+            if (m_sqes != MAP_FAILED) {
+                munmap(m_sqes, m_sqesSize);
+            }
+            if (m_cqRing != MAP_FAILED && m_cqRing != m_sqRing) {
+                munmap(m_cqRing, m_cqRingSize);
+            }
+            if (m_sqRing != MAP_FAILED) {
+                munmap(m_sqRing, m_sqRingSize);
+            }
+            if (m_fd >= 0) {
+                ::close(m_fd);
+            }
+        }
+
+        int m_fd = -1;
+        void* m_sqRing = MAP_FAILED;
+        void* m_cqRing = MAP_FAILED;
+        io_uring_sqe* m_sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t m_sqRingSize = 0;
+        size_t m_cqRingSize = 0;
+        size_t m_sqesSize = 0;
+        unsigned* m_sqTail = nullptr;
+        unsigned* m_sqArray = nullptr;
+        unsigned m_sqMask = 0;
+        unsigned* m_cqHead = nullptr;
+        unsigned* m_cqTail = nullptr;
+        unsigned m_cqMask = 0;
+        io_uring_cqe* m_cqes = nullptr;
+        unsigned m_unsubmitted = 0;
+    };
+
+    /**
+     * @brief FileWriter that submits full buffers through io_uring
+     *
+     * Formatted records are copied into one of URING_BUFFERS registered
+     * buffers; a full buffer is submitted as a single write at its file
+     * offset and the writer moves on to the next buffer, so formatting
+     * continues while the kernel writes. The writer only blocks when it
+     * cycles back to a buffer whose write has not completed, and in flush().
+     * Short or failed writes are finished with pwrite().
+     */
+    class UringWriter : public FileWriter {
+    public:
+        UringWriter()
+            : m_ring(static_cast<unsigned>(2 * LoggerConstants::URING_BUFFERS)),
+              m_memory(static_cast<char*>(Pages::map(BUFFERS * BUFFER_SIZE, PageMode::NORMAL))) {
+            for (size_t i = 0; i < BUFFERS; ++i) {
+                m_buffers[i] = {m_memory + i * BUFFER_SIZE, BUFFER_SIZE};
+            }
+            m_fixed = m_ring.registerBuffers(m_buffers.data(), static_cast<unsigned>(BUFFERS));
+        }
+
+        ~UringWriter() override {
+            try {
+                close();
+            } catch (...) {
+                // Reported by the sink's flush path when it matters
+            }
+            Pages::unmap(m_memory, BUFFERS * BUFFER_SIZE, PageMode::NORMAL);
+        }
+
+        void open(const std::string& path, bool truncate) override {
+            m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+            if (m_fd < 0) {
+                spdlog::throw_spdlog_ex("Failed opening file " + path + " for writing", errno);
+            }
+            off_t end = ::lseek(m_fd, 0, SEEK_END);
+            m_offset = end > 0 ? static_cast<uint64_t>(end) : 0;
+            m_path = path;
+        }
+
+        void write(const char* data, size_t size) override {
+            while (size > 0) {
+                size_t chunk = std::min(size, BUFFER_SIZE - m_fill);
+                std::memcpy(static_cast<char*>(m_buffers[m_current].iov_base) + m_fill, data, chunk);
+                m_fill += chunk;
+                data += chunk;
+                size -= chunk;
+                if (m_fill == BUFFER_SIZE) {
+                    submitCurrent();
+                }
+            }
+        }
+
+        void flush() override {
+            submitCurrent();
+            for (size_t i = 0; i < BUFFERS; ++i) {
+                waitFor(i);
+            }
+        }
+
+        void close() override {
+            if (m_fd < 0) {
+                return;
+            }
+            struct Closer {
+                int& fd;
+                ~Closer() {
+                    ::close(fd);
+                    fd = -1;
+                }
+            } closer{m_fd};
+            flush();
+        }
+
+        [[nodiscard]] size_t size() const override { return static_cast<size_t>(m_offset) + m_fill; }
+        [[nodiscard]] int descriptor() const override { return m_fd; }
+
+        /**
+         * @brief Whether writes use registered buffers (IORING_OP_WRITE_FIXED)
+         */
+        [[nodiscard]] bool fixedBuffers() const { return m_fixed; }
+
+    private:
+        static constexpr size_t BUFFERS = LoggerConstants::URING_BUFFERS;
+        static constexpr size_t BUFFER_SIZE = LoggerConstants::URING_BUFFER_SIZE;
+
+        void submitCurrent() {
+            if (m_fill == 0) {
+                return;
+            }
+            size_t index = m_current;
+            m_pending[index] = {m_buffers[index].iov_base, m_fill};
+            m_pendingOffset[index] = m_offset;
+            m_inFlight[index] = true;
+            m_ring.prepareWrite(m_fd, m_pending[index], m_offset, m_fixed ? static_cast<int>(index) : -1, index);
+            m_offset += m_fill;
+            m_fill = 0;
+            m_current = (m_current + 1) % BUFFERS;
+            m_ring.enter(0);
+            waitFor(m_current);
+        }
+
+        void waitFor(size_t index) {
+            while (m_inFlight[index]) {
+                uint64_t completed = 0;
+                int result = 0;
+                while (!m_ring.reap(completed, result)) {
+                    m_ring.enter(1);
+                }
+                complete(static_cast<size_t>(completed), result);
+            }
+        }
+
+        void complete(size_t index, int result) {
+            m_inFlight[index] = false;
+            const char* rest = static_cast<const char*>(m_pending[index].iov_base);
+            size_t left = m_pending[index].iov_len;
+            uint64_t offset = m_pendingOffset[index];
+            size_t written = result > 0 ? static_cast<size_t>(result) : 0;
+            rest += written;
+            left -= std::min(written, left);
+            offset += written;
+            while (left > 0) {
+                ssize_t n = ::pwrite(m_fd, rest, left, static_cast<off_t>(offset));
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    spdlog::throw_spdlog_ex("Failed writing to file " + m_path, errno);
+                }
+                rest += n;
+                left -= static_cast<size_t>(n);
+                offset += static_cast<uint64_t>(n);
+            }
+        }
+
+        IoUring m_ring;
+        char* m_memory;
+        std::array<iovec, BUFFERS> m_buffers{};
+        std::array<iovec, BUFFERS> m_pending{};      ///< Data of each in-flight write
+        std::array<uint64_t, BUFFERS> m_pendingOffset{};
+        std::array<bool, BUFFERS> m_inFlight{};
+        bool m_fixed = false;
+        size_t m_current = 0;   ///< Buffer being filled
+        size_t m_fill = 0;      ///< Bytes in the current buffer
+        uint64_t m_offset = 0;  ///< File offset of the current buffer's first byte
+        int m_fd = -1;
+        std::string m_path;
+    };
+#endif
+
+    /**
+     * @brief FileWriter that appends with memcpy into a shared mapping of the file
+     *
+     * The file is extended with fallocate() one segment at a time and the
+     * segment is mapped; a record is a memcpy and the kernel writes the pages
+     * back. close() (and so rotation) truncates the file to the bytes written;
+     * flush() leaves the preallocated tail in place, so a live file ends in
+     * NUL padding up to the segment end.
+     *
+     * Crash consistency: every byte copied before the process dies is in the
+     * page cache and reaches the file. The NUL padding of a file that was not
+     * closed is trimmed by CrashHandler, and otherwise open() strips it the
+     * next time the file is appended to.
+     * Only the kernel's writeback (or an fdatasync) protects against a power
+     * loss, exactly as for buffered writes.
+     */
+    class MmapWriter : public FileWriter {
+    public:
+        /**
+         * @param segmentSize Bytes preallocated and mapped at a time, rounded to pages
+         */
+        explicit MmapWriter(size_t segmentSize)
+            : m_page(static_cast<size_t>(::sysconf(_SC_PAGESIZE))),
+              m_segment(Pages::roundUp(std::max<size_t>(segmentSize, 1), m_page)) {}
+
+        ~MmapWriter() override {
+            try {
+                close();
+            } catch (...) {
+                // Reported by the sink's flush path when it matters
+            }
+        }
+
+        void open(const std::string& path, bool truncate) override {
+            m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+            if (m_fd < 0) {
+                spdlog::throw_spdlog_ex("Failed opening file " + path + " for writing", errno);
+            }
+            m_path = path;
+            off_t end = ::lseek(m_fd, 0, SEEK_END);
+            m_used = end > 0 ? static_cast<uint64_t>(end) : 0;
+            m_allocated = m_used;
+            // Left by a process that died between flushes
+            m_used = contentEnd(m_used);
+            if (m_used != m_allocated && ::ftruncate(m_fd, static_cast<off_t>(m_used)) == 0) {
+                m_allocated = m_used;
+            }
+            m_entry = MappedFiles::claim(m_fd, m_used);
+        }
+
+        void write(const char* data, size_t size) override {
+            while (size > 0) {
+                if (m_map == nullptr || m_used == m_mapEnd) {
+                    mapSegment();
+                }
+                uint64_t end = std::min<uint64_t>(m_mapEnd, m_used + size);
+                if (end > m_allocated) {
+                    allocate(m_mapEnd);
+                }
+                size_t chunk = static_cast<size_t>(end - m_used);
+                std::memcpy(m_map + (m_used - m_mapStart), data, chunk);
+                m_used += chunk;
+                data += chunk;
+                size -= chunk;
+            }
+            if (m_entry != nullptr) {
+                m_entry->length.store(m_used, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Nothing to do: the bytes are already in the page cache
+         *
+         * The preallocated tail is kept so a busy file is not truncated and
+         * re-extended on every flush; close() and rotation trim it.
+         */
+        void flush() override {}
+
+        void close() override {
+            if (m_fd < 0) {
+                return;
+            }
+            unmap();
+            int result = ::ftruncate(m_fd, static_cast<off_t>(m_used));
+            int error = errno;
+            MappedFiles::release(m_entry);
+            m_entry = nullptr;
+            ::close(m_fd);
+            m_fd = -1;
+            if (result != 0) {
+                spdlog::throw_spdlog_ex("Failed truncating file " + m_path, error);
+            }
+        }
+
+        [[nodiscard]] size_t size() const override { return static_cast<size_t>(m_used); }
+        [[nodiscard]] int descriptor() const override { return m_fd; }
+
+    private:
+        /**
+         * @brief Offset after the last non-NUL byte, looking back at most one segment
+         */
+        uint64_t contentEnd(uint64_t end) const {
+            char block[4096];
+            uint64_t limit = end > m_segment ? end - m_segment : 0;
+            while (end > limit) {
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>(sizeof(block), end - limit));
+                ssize_t n = ::pread(m_fd, block, chunk, static_cast<off_t>(end - chunk));
+                if (n != static_cast<ssize_t>(chunk)) {
+                    return end;
+                }
+                for (size_t i = chunk; i > 0; --i) {
+                    if (block[i - 1] != '\0') {
+                        return end - chunk + i;
+                    }
+                }
+                end -= chunk;
+            }
+            return end;
+        }
+
+        /**
+         * @brief Map the segment starting at the page that holds the next byte
+         */
+        void mapSegment() {
+            unmap();
+            uint64_t start = m_used / m_page * m_page;
+            void* address = mmap(nullptr, m_segment, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd,
+                                 static_cast<off_t>(start));
+            if (address == MAP_FAILED) {
+                spdlog::throw_spdlog_ex("Failed mapping file " + m_path, errno);
+            }
+            m_map = static_cast<char*>(address);
+            m_mapStart = start;
+            m_mapEnd = start + m_segment;
+        }
+
+        /**
+         * @brief Reserve disk blocks up to end before any page there is touched
+         *
+         * Without blocks behind it a page fault on a full disk is a SIGBUS. File
+         * systems without fallocate() get a sparse extension instead.
+         */
+        void allocate(uint64_t end) {
+            if (::fallocate(m_fd, 0, static_cast<off_t>(m_allocated), static_cast<off_t>(end - m_allocated)) != 0) {
+                if (errno != EOPNOTSUPP && errno != ENOSYS) {
+                    spdlog::throw_spdlog_ex("Failed preallocating file " + m_path, errno);
+                }
+                if (::ftruncate(m_fd, static_cast<off_t>(end)) != 0) {
+                    spdlog::throw_spdlog_ex("Failed extending file " + m_path, errno);
+                }
+            }
+            m_allocated = end;
+        }
+
+        void unmap() {
+            if (m_map != nullptr) {
+                munmap(m_map, m_segment);
+                m_map = nullptr;
+            }
+        }
+
+        size_t m_page;
+        size_t m_segment;
+        int m_fd = -1;
+        std::string m_path;
+        char* m_map = nullptr;
+        uint64_t m_mapStart = 0;
+        uint64_t m_mapEnd = 0;
+        uint64_t m_used = 0;       ///< Bytes written
+        uint64_t m_allocated = 0;  ///< File length; past m_used until close()
+        MappedFiles::Entry* m_entry = nullptr;
+    };
+
+    /**
+     * @brief FileWriter that bypasses the page cache with O_DIRECT
+     *
+     * Records fill one of two aligned DIRECT_BUFFER_SIZE buffers; a full
+     * buffer goes to a helper thread that writes it while the other one
+     * fills. flush() writes the whole blocks held so far directly and the
+     * partial last block through a second, buffered descriptor, so nothing is
+     * padded; that block is rewritten directly once it fills up. close()
+     * pads the last block to the alignment and truncates the padding away.
+     */
+    class DirectWriter : public FileWriter {
+    public:
+        /**
+         * @brief Whether the file system at path accepts O_DIRECT (tmpfs and some FUSE do not)
+         */
+        static bool supported(const std::string& path) {
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | O_DIRECT, 0644);
+            if (fd < 0) {
+                return errno != EINVAL;
+            }
+            ::close(fd);
+            return true;
+        }
+
+        DirectWriter()
+            : m_memory(static_cast<char*>(Pages::map(2 * BUFFER_SIZE, PageMode::NORMAL))),
+              m_io([this]() { ioLoop(); }) {}
+
+        ~DirectWriter() override {
+            try {
+                close();
+            } catch (...) {
+                // Reported by the sink's flush path when it matters
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_ioMutex);
+                m_ioStop = true;
+            }
+            m_ioReady.notify_all();
+            m_io.join();
+            Pages::unmap(m_memory, 2 * BUFFER_SIZE, PageMode::NORMAL);
+        }
+
+        void open(const std::string& path, bool truncate) override {
+            m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | O_DIRECT | (truncate ? O_TRUNC : 0), 0644);
+            if (m_fd < 0) {
+                spdlog::throw_spdlog_ex("Failed opening file " + path + " for direct writing", errno);
+            }
+            m_tailFd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+            if (m_tailFd < 0) {
+                int error = errno;
+                ::close(m_fd);
+                m_fd = -1;
+                spdlog::throw_spdlog_ex("Failed opening file " + path + " for writing", error);
+            }
+            m_path = path;
+            off_t end = ::lseek(m_tailFd, 0, SEEK_END);
+            uint64_t length = end > 0 ? static_cast<uint64_t>(end) : 0;
+            // Continue a partial last block in memory so that it is rewritten whole
+            m_offset = length / ALIGNMENT * ALIGNMENT;
+            m_fill = static_cast<size_t>(length - m_offset);
+            if (m_fill > 0 && ::pread(m_tailFd, current(), m_fill, static_cast<off_t>(m_offset)) !=
+                                  static_cast<ssize_t>(m_fill)) {
+                m_offset = length;  // Unreadable: start a fresh, unaligned run with buffered tails
+                m_fill = 0;
+            }
+        }
+
+        void write(const char* data, size_t size) override {
+            while (size > 0) {
+                size_t chunk = std::min(size, BUFFER_SIZE - m_fill);
+                std::memcpy(current() + m_fill, data, chunk);
+                m_fill += chunk;
+                data += chunk;
+                size -= chunk;
+                if (m_fill == BUFFER_SIZE) {
+                    handOff();
+                }
+            }
+        }
+
+        void flush() override {
+            if (m_fd < 0) {
+                return;
+            }
+            waitIdle();
+            size_t aligned = m_offset % ALIGNMENT == 0 ? m_fill / ALIGNMENT * ALIGNMENT : 0;
+            if (aligned > 0) {
+                writeOrThrow(m_fd, current(), aligned, m_offset);
+            }
+            size_t tail = m_fill - aligned;
+            if (tail > 0) {
+                writeOrThrow(m_tailFd, current() + aligned, tail, m_offset + aligned);
+            }
+            std::memmove(current(), current() + aligned, tail);
+            m_offset += aligned;
+            m_fill = tail;
+        }
+
+        void close() override {
+            if (m_fd < 0) {
+                return;
+            }
+            struct Closer {
+                int& fd;
+                int& tailFd;
+                ~Closer() {
+                    ::close(fd);
+                    ::close(tailFd);
+                    fd = tailFd = -1;
+                }
+            } closer{m_fd, m_tailFd};
+            waitIdle();
+            uint64_t length = m_offset + m_fill;
+            if (m_fill > 0) {
+                if (m_offset % ALIGNMENT == 0) {
+                    size_t padded = Pages::roundUp(m_fill, ALIGNMENT);
+                    std::memset(current() + m_fill, 0, padded - m_fill);
+                    writeOrThrow(m_fd, current(), padded, m_offset);
+                } else {
+                    writeOrThrow(m_tailFd, current(), m_fill, m_offset);
+                }
+            }
+            m_fill = 0;
+            if (::ftruncate(m_tailFd, static_cast<off_t>(length)) != 0) {
+                spdlog::throw_spdlog_ex("Failed truncating file " + m_path, errno);
+            }
+        }
+
+        [[nodiscard]] size_t size() const override { return static_cast<size_t>(m_offset + m_fill); }
+        [[nodiscard]] int descriptor() const override { return m_fd; }
+
+    private:
+        static constexpr size_t BUFFER_SIZE = LoggerConstants::DIRECT_BUFFER_SIZE;
+        static constexpr size_t ALIGNMENT = LoggerConstants::DIRECT_IO_ALIGNMENT;
+
+        char* current() { return m_memory + m_current * BUFFER_SIZE; }
+
+        /**
+         * @brief Give the full current buffer to the helper thread and switch buffers
+         */
+        void handOff() {
+            waitIdle();
+            if (m_offset % ALIGNMENT != 0) {
+                // Only after reopening an unreadable partial block; stay buffered
+                writeOrThrow(m_tailFd, current(), m_fill, m_offset);
+            } else {
+                std::lock_guard<std::mutex> lock(m_ioMutex);
+                m_ioData = current();
+                m_ioLength = m_fill;
+                m_ioOffset = m_offset;
+                m_ioPending = true;
+                m_ioReady.notify_all();
+            }
+            m_offset += m_fill;
+            m_fill = 0;
+            m_current ^= 1;
+        }
+
+        void waitIdle() {
+            std::unique_lock<std::mutex> lock(m_ioMutex);
+            m_ioDone.wait(lock, [this]() { return !m_ioPending; });
+            if (m_ioError != 0) {
+                int error = std::exchange(m_ioError, 0);
+                spdlog::throw_spdlog_ex("Failed writing to file " + m_path, error);
+            }
+        }
+
+        void ioLoop() {
+            std::unique_lock<std::mutex> lock(m_ioMutex);
+            while (true) {
+                m_ioReady.wait(lock, [this]() { return m_ioPending || m_ioStop; });
+                if (!m_ioPending) {
+                    return;
+                }
+                lock.unlock();
+                int error = writeAll(m_fd, m_ioData, m_ioLength, m_ioOffset);
+                lock.lock();
+                m_ioError = error;
+                m_ioPending = false;
+                m_ioDone.notify_all();
+            }
+        }
+
+        /**
+         * @return 0, or the errno of the failed write
+         */
+        static int writeAll(int fd, const char* data, size_t length, uint64_t offset) {
+            while (length > 0) {
+                ssize_t n = ::pwrite(fd, data, length, static_cast<off_t>(offset));
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return errno;
+                }
+                data += n;
+                length -= static_cast<size_t>(n);
+                offset += static_cast<uint64_t>(n);
+            }
+            return 0;
+        }
+
+        void writeOrThrow(int fd, const char* data, size_t length, uint64_t offset) {
+            int error = writeAll(fd, data, length, offset);
+            if (error != 0) {
+                spdlog::throw_spdlog_ex("Failed writing to file " + m_path, error);
+            }
+        }
+
+        char* m_memory;             ///< Two page-aligned buffers
+        size_t m_current = 0;       ///< Buffer being filled
+        size_t m_fill = 0;
+        uint64_t m_offset = 0;      ///< File offset of the current buffer's first byte
+        int m_fd = -1;              ///< O_DIRECT descriptor
+        int m_tailFd = -1;          ///< Buffered descriptor for partial blocks
+        std::string m_path;
+
+        std::mutex m_ioMutex;
+        std::condition_variable m_ioReady;
+        std::condition_variable m_ioDone;
+        const char* m_ioData = nullptr;
+        size_t m_ioLength = 0;
+        uint64_t m_ioOffset = 0;
+        bool m_ioPending = false;
+        bool m_ioStop = false;
+        int m_ioError = 0;
+        std::thread m_io;  ///< Declared last: starts once the state above exists
+    };
+
+    /**
+     * @brief FileWriter that writes through the page cache and drops what it wrote
+     *
+     * Each DIRECT_BUFFER_SIZE chunk is written, its writeback is started with
+     * sync_file_range(), and the chunk before it, by then usually on disk, is
+     * waited for and evicted with posix_fadvise(POSIX_FADV_DONTNEED). At most
+     * about two chunks of the file stay cached.
+     */
+    class DropCacheWriter : public FileWriter {
+    public:
+        DropCacheWriter() : m_buffer(new char[LoggerConstants::DIRECT_BUFFER_SIZE]) {}
+
+        ~DropCacheWriter() override {
+            try {
+                close();
+            } catch (...) {
+                // Reported by the sink's flush path when it matters
+            }
+        }
+
+        void open(const std::string& path, bool truncate) override {
+            m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+            if (m_fd < 0) {
+                spdlog::throw_spdlog_ex("Failed opening file " + path + " for writing", errno);
+            }
+            m_path = path;
+            off_t end = ::lseek(m_fd, 0, SEEK_END);
+            m_offset = end > 0 ? static_cast<uint64_t>(end) : 0;
+            m_dropped = m_offset;
+            m_started = m_offset;
+        }
+
+        void write(const char* data, size_t size) override {
+            while (size > 0) {
+                size_t chunk = std::min(size, LoggerConstants::DIRECT_BUFFER_SIZE - m_fill);
+                std::memcpy(m_buffer.get() + m_fill, data, chunk);
+                m_fill += chunk;
+                data += chunk;
+                size -= chunk;
+                if (m_fill == LoggerConstants::DIRECT_BUFFER_SIZE) {
+                    writeOut();
+                }
+            }
+        }
+
+        void flush() override {
+            if (m_fd >= 0) {
+                writeOut();
+            }
+        }
+
+        void close() override {
+            if (m_fd < 0) {
+                return;
+            }
+            struct Closer {
+                int& fd;
+                ~Closer() {
+                    ::close(fd);
+                    fd = -1;
+                }
+            } closer{m_fd};
+            writeOut();
+            drop(m_offset);
+        }
+
+        [[nodiscard]] size_t size() const override { return static_cast<size_t>(m_offset) + m_fill; }
+        [[nodiscard]] int descriptor() const override { return m_fd; }
+
+    private:
+        void writeOut() {
+            const char* data = m_buffer.get();
+            size_t length = m_fill;
+            while (length > 0) {
+                ssize_t n = ::pwrite(m_fd, data, length, static_cast<off_t>(m_offset));
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    spdlog::throw_spdlog_ex("Failed writing to file " + m_path, errno);
+                }
+                data += n;
+                length -= static_cast<size_t>(n);
+                m_offset += static_cast<uint64_t>(n);
+            }
+            m_fill = 0;
+            if (m_offset - m_started >= LoggerConstants::DIRECT_BUFFER_SIZE) {
+                // Evict the chunk whose writeback was started last time, then start this one
+                drop(m_started);
+                ::sync_file_range(m_fd, static_cast<off_t>(m_started), static_cast<off_t>(m_offset - m_started),
+                                  SYNC_FILE_RANGE_WRITE);
+                m_started = m_offset;
+            }
+        }
+
+        /**
+         * @brief Wait for writeback of [m_dropped, end) and evict it from the page cache
+         */
+        void drop(uint64_t end) {
+            if (end <= m_dropped) {
+                return;
+            }
+            auto offset = static_cast<off_t>(m_dropped);
+            auto length = static_cast<off_t>(end - m_dropped);
+            ::sync_file_range(m_fd, offset, length,
+                              SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+            ::posix_fadvise(m_fd, offset, length, POSIX_FADV_DONTNEED);
+            m_dropped = end;
+        }
+
+        std::unique_ptr<char[]> m_buffer;
+        size_t m_fill = 0;
+        uint64_t m_offset = 0;   ///< File length written so far
+        uint64_t m_started = 0;  ///< Writeback has been started for everything before this
+        uint64_t m_dropped = 0;  ///< Everything before this has been evicted
+        int m_fd = -1;
+        std::string m_path;
+    };
+
+    /**
+     * @brief FileWriter with a plain write(2) buffer; what STDIO uses when it needs a FileSink
+     */
+    class BufferedWriter : public FileWriter {
+    public:
+        BufferedWriter() : m_buffer(new char[LoggerConstants::FILE_BUFFER_SIZE]) {}
+
+        ~BufferedWriter() override {
+            try {
+                close();
+            } catch (...) {
+                // Reported by the sink's flush path when it matters
+            }
+        }
+
+        void open(const std::string& path, bool truncate) override {
+            m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+            if (m_fd < 0) {
+                spdlog::throw_spdlog_ex("Failed opening file " + path + " for writing", errno);
+            }
+            m_path = path;
+            off_t end = ::lseek(m_fd, 0, SEEK_END);
+            m_written = end > 0 ? static_cast<size_t>(end) : 0;
+        }
+
+        void write(const char* data, size_t size) override {
+            if (m_fill + size > LoggerConstants::FILE_BUFFER_SIZE) {
+                writeOut(m_buffer.get(), std::exchange(m_fill, 0));
+            }
+            if (size >= LoggerConstants::FILE_BUFFER_SIZE) {
+                writeOut(data, size);
+                return;
+            }
+            std::memcpy(m_buffer.get() + m_fill, data, size);
+            m_fill += size;
+        }
+
+        void flush() override {
+            if (m_fd >= 0) {
+                writeOut(m_buffer.get(), std::exchange(m_fill, 0));
+            }
+        }
+
+        void close() override {
+            if (m_fd < 0) {
+                return;
+            }
+            struct Closer {
+                int& fd;
+                ~Closer() {
+                    ::close(fd);
+                    fd = -1;
+                }
+            } closer{m_fd};
+            flush();
+        }
+
+        [[nodiscard]] size_t size() const override { return m_written + m_fill; }
+        [[nodiscard]] int descriptor() const override { return m_fd; }
+
+    private:
+        void writeOut(const char* data, size_t length) {
+            while (length > 0) {
+                ssize_t n = ::write(m_fd, data, length);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    spdlog::throw_spdlog_ex("Failed writing to file " + m_path, errno);
+                }
+                data += n;
+                length -= static_cast<size_t>(n);
+                m_written += static_cast<size_t>(n);
+            }
+        }
+
+        std::unique_ptr<char[]> m_buffer;
+        size_t m_fill = 0;
+        size_t m_written = 0;
+        int m_fd = -1;
+        std::string m_path;
+    };
+
+#ifdef FRESHLOGGER_WITH_ZLIB
+    /**
+     * @brief FileWriter that stores the text as a sequence of independent gzip members
+     *
+     * Records collect in a GZIP_FRAME_SIZE buffer that is compressed as one
+     * complete member when full and on flush(), so a crash loses at most
+     * the frame being filled. The file is a valid multi-member gzip stream.
+     * Each member's header carries an FEXTRA subfield 'F','L' with the
+     * member's compressed length (4 bytes, little-endian), so a reader can
+     * hop from frame to frame without inflating. size() estimates the
+     * buffered text at the previous frame's compression ratio.
+     */
+    class GzipWriter : public FileWriter {
+    public:
+        GzipWriter() : m_frame(new char[LoggerConstants::GZIP_FRAME_SIZE]) {
+            int status = ::deflateInit2(&m_stream, LoggerConstants::GZIP_STREAM_LEVEL, Z_DEFLATED, 15 + 16, 8,
+                                        Z_DEFAULT_STRATEGY);
+            if (status != Z_OK) {
+                spdlog::throw_spdlog_ex("GzipWriter: deflateInit2 failed");
+            }
+            m_output.resize(::deflateBound(&m_stream, LoggerConstants::GZIP_FRAME_SIZE) + sizeof(m_extra) + 2);
+        }
+
+        ~GzipWriter() override {
+            try {
+                close();
+            } catch (...) {
+                // Reported by the sink's flush path when it matters
+            }
+            ::deflateEnd(&m_stream);
+        }
+
+        void open(const std::string& path, bool truncate) override {
+            m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+            if (m_fd < 0) {
+                spdlog::throw_spdlog_ex("Failed opening file " + path + " for writing", errno);
+            }
+            m_path = path;
+            off_t end = ::lseek(m_fd, 0, SEEK_END);
+            m_written = end > 0 ? static_cast<size_t>(end) : 0;
+        }
+
+        void write(const char* data, size_t size) override {
+            while (size > 0) {
+                size_t chunk = std::min(size, LoggerConstants::GZIP_FRAME_SIZE - m_fill);
+                std::memcpy(m_frame.get() + m_fill, data, chunk);
+                m_fill += chunk;
+                data += chunk;
+                size -= chunk;
+                if (m_fill == LoggerConstants::GZIP_FRAME_SIZE) {
+                    writeFrame();
+                }
+            }
+        }
+
+        void flush() override {
+            if (m_fd >= 0 && m_fill > 0) {
+                writeFrame();
+            }
+        }
+
+        void close() override {
+            if (m_fd < 0) {
+                return;
+            }
+            struct Closer {
+                int& fd;
+                ~Closer() {
+                    ::close(fd);
+                    fd = -1;
+                }
+            } closer{m_fd};
+            flush();
+        }
+
+        [[nodiscard]] size_t size() const override {
+            return m_written + static_cast<size_t>(static_cast<double>(m_fill) * m_ratio);
+        }
+
+        [[nodiscard]] int descriptor() const override { return m_fd; }
+
+    private:
+        static constexpr size_t LENGTH_OFFSET = 16;  ///< 10-byte header, XLEN, then 'F','L' and the subfield length
+
+        void writeFrame() {
+            gz_header header{};
+            header.os = 3;  // Unix
+            header.extra = m_extra;
+            header.extra_len = sizeof(m_extra);
+            ::deflateReset(&m_stream);
+            ::deflateSetHeader(&m_stream, &header);
+            m_stream.next_in = reinterpret_cast<Bytef*>(m_frame.get());
+            m_stream.avail_in = static_cast<uInt>(m_fill);
+            m_stream.next_out = m_output.data();
+            m_stream.avail_out = static_cast<uInt>(m_output.size());
+            if (::deflate(&m_stream, Z_FINISH) != Z_STREAM_END) {
+                spdlog::throw_spdlog_ex("GzipWriter: deflate failed for " + m_path);
+            }
+            size_t length = m_output.size() - m_stream.avail_out;
+            for (size_t i = 0; i < 4; ++i) {
+                m_output[LENGTH_OFFSET + i] = static_cast<Bytef>(length >> (8 * i));
+            }
+            const Bytef* data = m_output.data();
+            size_t remaining = length;
+            while (remaining > 0) {
+                ssize_t n = ::write(m_fd, data, remaining);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    spdlog::throw_spdlog_ex("Failed writing to file " + m_path, errno);
+                }
+                data += n;
+                remaining -= static_cast<size_t>(n);
+            }
+            m_written += length;
+            m_ratio = static_cast<double>(length) / static_cast<double>(m_fill);
+            m_fill = 0;
+        }
+
+        z_stream m_stream{};
+        Bytef m_extra[8] = {'F', 'L', 4, 0, 0, 0, 0, 0};  ///< Length bytes are patched into the output
+        std::unique_ptr<char[]> m_frame;
+        size_t m_fill = 0;
+        double m_ratio = 1.0;  ///< Compressed to raw bytes of the last frame
+        std::vector<Bytef> m_output;
+        size_t m_written = 0;
+        int m_fd = -1;
+        std::string m_path;
+    };
+#endif
+
+    /**
+     * @brief Local-time boundary at which FileSink starts a new file regardless of size
+     */
+    enum class RotationPeriod {
+        NONE,
+        HOURLY,
+        DAILY
+    };
+
+    /**
+     * @brief File sink tuning derived from Logger::Config
+     */
+    struct FileSinkOptions {
+        size_t maxSize = LoggerConstants::DEFAULT_MAX_FILE_SIZE;
+        size_t maxFiles = LoggerConstants::DEFAULT_MAX_FILES;
+        uint64_t maxTotalSize = 0;     ///< Rotated files are deleted oldest first beyond this many bytes; 0 disables
+        RotationPeriod period = RotationPeriod::NONE;
+        bool sync = false;                     ///< fdatasync() the file on every commit and before closing it
+        std::chrono::milliseconds flushInterval{0};  ///< Flush once the oldest unflushed record is this old; 0 disables
+        bool asyncRotation = false;    ///< Pre-open the next file and rename on a helper thread
+        bool sequentialNames = false;  ///< Rotated files get increasing numbers instead of cascading
+        bool compress = false;         ///< gzip rotated files on a helper thread; needs sequentialNames and zlib
+    };
+
+    /**
+     * @brief Size-rotating file sink writing through FileWriters
+     *
+     * Rotation matches spdlog's rotating_file_sink: log.txt is renamed to
+     * log.1.txt, log.1.txt to log.2.txt and so on up to maxFiles. With
+     * sequential names log.txt is renamed to the next number instead
+     * (log.7.txt after log.6.txt) and the lowest number beyond maxFiles is
+     * deleted, so a rotation is one rename and one unlink however many
+     * files are kept. Numbering continues from the files already present.
+     *
+     * A rotation period also starts a new file at each local hour or
+     * midnight. The next boundary is computed once per rotation and every
+     * record's timestamp, which spdlog has already taken, is compared with
+     * it; no clock is read per record. A file left by a process in an
+     * earlier period is rotated by the first record.
+     *
+     * flush() hands buffered records to the kernel and, with sync, waits
+     * for fdatasync(). Group commit is the engine's job: it decides how
+     * often the sink is flushed (see QueueEngine).
+     *
+     * With a flush interval a timer thread flushes the sink once the oldest
+     * unflushed record has waited that long, so an idle process does not
+     * keep its last records in the writer's buffer. The timer is armed by the
+     * first record after a flush and sleeps while nothing is buffered.
+     *
+     * With asynchronous rotation a helper thread keeps the next file open
+     * under a hidden name (.log.txt.next). Rotating only swaps writers on
+     * the write path; closing the full file, the renames, and moving the
+     * new file to log.txt happen on the helper, after which it opens the
+     * following one. Until the helper is done the newest lines are in the
+     * hidden file; a sink that finds it non-empty at startup finishes the
+     * interrupted rotation first.
+     */
+    class FileSink : public spdlog::sinks::base_sink<std::mutex> {
+    public:
+        using WriterFactory = std::function<std::unique_ptr<FileWriter>()>;
+
+        FileSink(std::string path, const FileSinkOptions& options, WriterFactory factory)
+            : m_path(std::move(path)), m_options(options), m_factory(std::move(factory)), m_writer(m_factory()) {
+#ifndef FRESHLOGGER_WITH_ZLIB
+            m_options.compress = false;
+#endif
+            if (m_options.sequentialNames) {
+                findRotated();
+            }
+            if (m_options.asyncRotation) {
+                std::filesystem::path file(m_path);
+                m_nextPath = (file.parent_path() / ("." + file.filename().string() + ".next")).string();
+                std::error_code error;
+                auto pending = std::filesystem::file_size(m_nextPath, error);
+                if (!error && pending > 0) {
+                    retireFile();
+                    moveNextIntoPlace();
+                }
+            }
+            m_writer->open(m_path, false);
+            if (m_options.period != RotationPeriod::NONE) {
+                struct stat file {};
+                bool written = ::stat(m_path.c_str(), &file) == 0 && file.st_size > 0;
+                m_deadline = nextBoundary(written ? spdlog::log_clock::from_time_t(file.st_mtime)
+                                                  : spdlog::log_clock::now());
+            }
+            if (m_options.asyncRotation) {
+                m_next = m_factory();
+                m_next->open(m_nextPath, true);
+                m_rotator = std::thread([this] { rotatorLoop(); });
+            }
+#ifdef FRESHLOGGER_WITH_ZLIB
+            if (m_options.compress) {
+                m_compressor = std::thread([this] { compressorLoop(); });
+            }
+#endif
+            if (m_options.flushInterval.count() > 0) {
+                m_flusher = std::thread([this] { flusherLoop(); });
+            }
+        }
+
+        ~FileSink() override {
+            try {
+                if (m_flusher.joinable()) {
+                    {
+                        std::lock_guard<std::mutex> lock(m_flushMutex);
+                        m_flushStopping = true;
+                    }
+                    m_flushCv.notify_all();
+                    m_flusher.join();
+                }
+                if (m_rotator.joinable()) {
+                    {
+                        std::lock_guard<std::mutex> lock(m_rotationMutex);
+                        m_stopping = true;
+                    }
+                    m_rotationCv.notify_all();
+                    m_rotator.join();
+                }
+                if (m_compressor.joinable()) {
+                    {
+                        std::lock_guard<std::mutex> lock(m_retentionMutex);
+                        m_compressStopping = true;
+                    }
+                    m_compressCv.notify_all();
+                    m_compressor.join();
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                syncWriter(*m_writer);
+                m_writer->close();
+                if (m_next) {
+                    m_next->close();
+                    std::remove(m_nextPath.c_str());
+                }
+            } catch (...) {
+                // Nothing left to report to
+            }
+        }
+
+        [[nodiscard]] const std::string& path() const { return m_path; }
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override {
+            m_formatted.clear();
+            formatter_->format(msg, m_formatted);
+            std::string rotationError;
+            bool due = msg.time >= m_deadline;
+            if (due) {
+                m_deadline = nextBoundary(msg.time);
+            }
+            if (m_writer->size() > 0 && (due || m_writer->size() + m_formatted.size() > m_options.maxSize)) {
+                if (m_rotator.joinable()) {
+                    rotationError = swapWriters();
+                } else {
+                    rotate();
+                }
+            }
+            m_writer->write(m_formatted.data(), m_formatted.size());
+            if (!m_unflushed && m_flusher.joinable()) {
+                // Start the timer once per batch, not per record
+                m_unflushed = true;
+                {
+                    std::lock_guard<std::mutex> lock(m_flushMutex);
+                    m_flushPending = true;
+                }
+                m_flushCv.notify_one();
+            }
+            if (!rotationError.empty()) {
+                spdlog::throw_spdlog_ex(rotationError);
+            }
+        }
+
+        void flush_() override {
+            m_unflushed = false;
+            m_writer->flush();
+            syncWriter(*m_writer);
+        }
+
+    private:
+        /**
+         * @brief fdatasync() an open writer when the sink syncs
+         */
+        void syncWriter(FileWriter& writer) const {
+            if (!m_options.sync || writer.descriptor() < 0) {
+                return;
+            }
+            writer.flush();
+            if (::fdatasync(writer.descriptor()) != 0) {
+                spdlog::throw_spdlog_ex("FileSink: fdatasync failed for " + m_path, errno);
+            }
+        }
+
+        void flusherLoop() {
+            std::unique_lock<std::mutex> lock(m_flushMutex);
+            for (;;) {
+                m_flushCv.wait(lock, [this] { return m_flushPending || m_flushStopping; });
+                if (m_flushCv.wait_for(lock, m_options.flushInterval, [this] { return m_flushStopping; })) {
+                    return;
+                }
+                m_flushPending = false;
+                lock.unlock();
+                try {
+                    std::lock_guard<std::mutex> sinkLock(mutex_);
+                    flush_();
+                } catch (...) {
+                    // The writer fails again on the next record or flush, which reports it
+                }
+                lock.lock();
+            }
+        }
+
+        /**
+         * @brief Move the full log.txt aside under the configured naming
+         */
+        void retireFile() {
+            if (!m_options.sequentialNames) {
+                shiftFiles();
+                if (m_options.maxTotalSize > 0) {
+                    trimCascade();
+                }
+                return;
+            }
+            std::error_code error;
+            auto bytes = std::filesystem::file_size(m_path, error);
+            if (error) {
+                return;
+            }
+            auto target = rotatedName(m_nextIndex);
+            if (std::rename(m_path.c_str(), target.c_str()) != 0) {
+                spdlog::throw_spdlog_ex("FileSink: failed renaming " + m_path + " to " + target, errno);
+            }
+            std::lock_guard<std::mutex> lock(m_retentionMutex);
+            m_rotated.push_back({m_nextIndex, bytes});
+            m_rotatedBytes += bytes;
+            if (m_options.compress) {
+                m_compressQueue.push_back(m_nextIndex);
+                m_compressCv.notify_one();
+            }
+            ++m_nextIndex;
+            dropOldest();
+        }
+
+        /**
+         * @brief Start of the next local hour or day after a point in time
+         */
+        [[nodiscard]] spdlog::log_clock::time_point nextBoundary(spdlog::log_clock::time_point after) const {
+            std::time_t seconds = spdlog::log_clock::to_time_t(after);
+            std::tm local{};
+            ::localtime_r(&seconds, &local);
+            local.tm_sec = 0;
+            local.tm_min = 0;
+            if (m_options.period == RotationPeriod::DAILY) {
+                local.tm_hour = 0;
+                local.tm_mday += 1;
+            } else {
+                local.tm_hour += 1;
+            }
+            local.tm_isdst = -1;
+            return spdlog::log_clock::from_time_t(std::mktime(&local));
+        }
+
+        /**
+         * @brief Delete cascaded files, newest kept first, once their total exceeds maxTotalSize
+         */
+        void trimCascade() const {
+            uint64_t total = 0;
+            for (size_t i = 1; i <= m_options.maxFiles; ++i) {
+                auto name = rotatedName(i);
+                std::error_code error;
+                auto bytes = std::filesystem::file_size(name, error);
+                if (error) {
+                    continue;
+                }
+                total += bytes;
+                if (total > m_options.maxTotalSize) {
+                    std::remove(name.c_str());
+                }
+            }
+        }
+
+        [[nodiscard]] std::string rotatedName(size_t index) const {
+            return spdlog::sinks::rotating_file_sink_mt::calc_filename(m_path, index);
+        }
+
+        /**
+         * @brief Rename log.txt to log.1.txt, log.1.txt to log.2.txt, ... up to maxFiles
+         */
+        void shiftFiles() const {
+            for (size_t i = m_options.maxFiles; i > 0; --i) {
+                auto source = spdlog::sinks::rotating_file_sink_mt::calc_filename(m_path, i - 1);
+                if (!std::filesystem::exists(source)) {
+                    continue;
+                }
+                auto target = spdlog::sinks::rotating_file_sink_mt::calc_filename(m_path, i);
+                std::error_code ignored;
+                std::filesystem::remove(target, ignored);
+                if (std::rename(source.c_str(), target.c_str()) != 0) {
+                    spdlog::throw_spdlog_ex("FileSink: failed renaming " + source + " to " + target, errno);
+                }
+            }
+        }
+
+        /**
+         * @brief Collect the numbers of existing log.N.txt and log.N.txt.gz files, oldest first
+         *
+         * Uncompressed ones are queued for compression when it is on, and
+         * leftovers of interrupted compressions are deleted.
+         */
+        void findRotated() {
+            static const std::string compressed = ".gz";
+            static const std::string partial = ".gz.part";
+            auto hasSuffix = [](const std::string& name, const std::string& suffix) {
+                return name.size() > suffix.size() &&
+                       name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+            };
+            auto [base, extension] = spdlog::details::file_helper::split_by_extension(m_path);
+            std::filesystem::path basePath(base);
+            std::string prefix = basePath.filename().string() + ".";
+            std::filesystem::path directory = basePath.has_parent_path() ? basePath.parent_path() : ".";
+            struct Found {
+                size_t index;
+                bool compressed;
+                uint64_t bytes;
+                bool operator<(const Found& other) const {
+                    return std::tie(index, compressed) < std::tie(other.index, other.compressed);
+                }
+            };
+            std::vector<Found> found;
+            std::vector<std::filesystem::path> stale;
+            std::error_code error;
+            for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+                std::string name = entry.path().filename().string();
+                bool isPartial = hasSuffix(name, partial);
+                bool isCompressed = !isPartial && hasSuffix(name, compressed);
+                name.resize(name.size() - (isPartial ? partial.size() : isCompressed ? compressed.size() : 0));
+                if (name.size() <= prefix.size() + extension.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+                    name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+                    continue;
+                }
+                std::string digits = name.substr(prefix.size(), name.size() - prefix.size() - extension.size());
+                if (digits.size() > 18 || !std::all_of(digits.begin(), digits.end(),
+                                                       [](unsigned char c) { return std::isdigit(c) != 0; })) {
+                    continue;
+                }
+                if (isPartial) {
+                    stale.push_back(entry.path());
+                    continue;
+                }
+                found.push_back({static_cast<size_t>(std::stoull(digits)), isCompressed, entry.file_size(error)});
+            }
+            for (const auto& path : stale) {
+                std::filesystem::remove(path, error);
+            }
+            std::sort(found.begin(), found.end());
+            std::lock_guard<std::mutex> lock(m_retentionMutex);
+            for (size_t i = 0; i < found.size(); ++i) {
+                size_t index = found[i].index;
+                if (i + 1 < found.size() && found[i + 1].index == index) {
+                    // Compressed, but the original was not yet deleted
+                    std::remove(rotatedName(index).c_str());
+                    continue;
+                }
+                m_rotated.push_back({index, found[i].bytes});
+                m_rotatedBytes += found[i].bytes;
+                if (m_options.compress && !found[i].compressed) {
+                    m_compressQueue.push_back(index);
+                }
+            }
+            m_nextIndex = found.empty() ? 1 : found.back().index + 1;
+            dropOldest();
+        }
+
+        /**
+         * @brief Delete the oldest sequential files beyond maxFiles or maxTotalSize; m_retentionMutex held
+         */
+        void dropOldest() {
+            while (!m_rotated.empty() && (m_rotated.size() > m_options.maxFiles ||
+                                          (m_options.maxTotalSize > 0 && m_rotatedBytes > m_options.maxTotalSize))) {
+                auto oldest = rotatedName(m_rotated.front().index);
+                std::remove(oldest.c_str());
+                std::remove((oldest + ".gz").c_str());
+                m_rotatedBytes -= m_rotated.front().bytes;
+                m_rotated.pop_front();
+            }
+        }
+
+#ifdef FRESHLOGGER_WITH_ZLIB
+        /**
+         * @brief Compress queued rotated files one at a time, niced below the logging threads
+         *
+         * A file is written to log.N.txt.gz.part and renamed to log.N.txt.gz
+         * once complete, then the original is deleted. Stopping abandons the
+         * file in progress; the next sink on the path compresses it.
+         */
+        void compressorLoop() {
+            ::pthread_setname_np(::pthread_self(), "fl-compress");
+            // The nice value of a Linux thread is set through its thread id
+            ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), LoggerConstants::COMPRESSION_NICE);
+            std::unique_lock<std::mutex> lock(m_retentionMutex);
+            for (;;) {
+                m_compressCv.wait(lock, [this] { return !m_compressQueue.empty() || m_compressStopping; });
+                if (m_compressStopping) {
+                    return;
+                }
+                size_t index = m_compressQueue.front();
+                std::string source = rotatedName(index);
+                m_compressQueue.pop_front();
+                lock.unlock();
+                std::string target = source + ".gz";
+                bool complete = compressFile(source, target + ".part");
+                lock.lock();
+                // Still retained: dropOldest() deletes under the same lock
+                if (complete && std::filesystem::exists(source) &&
+                    std::rename((target + ".part").c_str(), target.c_str()) == 0) {
+                    std::remove(source.c_str());
+                    std::error_code error;
+                    auto bytes = std::filesystem::file_size(target, error);
+                    for (auto& rotated : m_rotated) {
+                        if (rotated.index == index && !error) {
+                            m_rotatedBytes = m_rotatedBytes - rotated.bytes + bytes;
+                            rotated.bytes = bytes;
+                        }
+                    }
+                } else {
+                    std::remove((target + ".part").c_str());
+                }
+            }
+        }
+
+        /**
+         * @brief gzip source into target
+         * @return False when stopped or on a read or write error
+         */
+        bool compressFile(const std::string& source, const std::string& target) const {
+            int in = ::open(source.c_str(), O_RDONLY | O_CLOEXEC);
+            if (in < 0) {
+                return false;
+            }
+            std::string mode = "wb" + std::to_string(LoggerConstants::GZIP_LEVEL);
+            gzFile out = ::gzopen(target.c_str(), mode.c_str());
+            std::unique_ptr<char[]> buffer(new char[LoggerConstants::COMPRESSION_CHUNK]);
+            bool complete = false;
+            while (out != nullptr && !m_compressStopping.load(std::memory_order_relaxed)) {
+                ssize_t n = ::read(in, buffer.get(), LoggerConstants::COMPRESSION_CHUNK);
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    complete = (n == 0);
+                    break;
+                }
+                if (::gzwrite(out, buffer.get(), static_cast<unsigned>(n)) != n) {
+                    break;
+                }
+            }
+            ::close(in);
+            if (out != nullptr && ::gzclose(out) != Z_OK) {
+                complete = false;
+            }
+            return complete;
+        }
+#endif
+
+        void moveNextIntoPlace() const {
+            if (std::rename(m_nextPath.c_str(), m_path.c_str()) != 0) {
+                spdlog::throw_spdlog_ex("FileSink: failed renaming " + m_nextPath + " to " + m_path, errno);
+            }
+        }
+
+        void rotate() {
+            syncWriter(*m_writer);
+            m_writer->close();
+            try {
+                retireFile();
+            } catch (...) {
+                m_writer->open(m_path, true);
+                throw;
+            }
+            m_writer->open(m_path, true);
+        }
+
+        /**
+         * @brief Continue in the pre-opened file and hand the full one to the helper
+         * @return Why the helper's previous rotation failed, empty if it did not
+         *
+         * Waits only when the helper is still busy with the previous rotation.
+         * Without a pre-opened file (the helper failed to prepare one) this
+         * rotates in place.
+         */
+        std::string swapWriters() {
+            std::unique_lock<std::mutex> lock(m_rotationMutex);
+            m_rotationCv.wait(lock, [this] { return !m_rotationPending; });
+            std::string error = std::exchange(m_rotationError, std::string());
+            if (m_next) {
+                m_retired = std::exchange(m_writer, std::move(m_next));
+            } else {
+                lock.unlock();
+                rotate();
+                lock.lock();
+            }
+            m_rotationPending = true;
+            m_rotationCv.notify_all();
+            return error;
+        }
+
+        void rotatorLoop() {
+            std::unique_lock<std::mutex> lock(m_rotationMutex);
+            for (;;) {
+                m_rotationCv.wait(lock, [this] { return m_rotationPending || m_stopping; });
+                if (!m_rotationPending) {
+                    return;
+                }
+                auto retired = std::move(m_retired);
+                lock.unlock();
+                std::unique_ptr<FileWriter> next;
+                std::string error;
+                try {
+                    if (retired) {
+                        syncWriter(*retired);
+                        retired->close();
+                        retired.reset();
+                        retireFile();
+                        moveNextIntoPlace();
+                    }
+                    next = m_factory();
+                    next->open(m_nextPath, true);
+                } catch (const std::exception& ex) {
+                    next.reset();
+                    error = ex.what();
+                }
+                lock.lock();
+                m_next = std::move(next);
+                m_rotationError = std::move(error);
+                m_rotationPending = false;
+                m_rotationCv.notify_all();
+            }
+        }
+
+        std::string m_path;
+        std::string m_nextPath;  ///< Hidden file the next rotation continues in
+        FileSinkOptions m_options;
+        WriterFactory m_factory;
+        std::unique_ptr<FileWriter> m_writer;
+        spdlog::memory_buf_t m_formatted;
+        size_t m_nextIndex = 1;  ///< Touched by one rotation at a time, on whichever thread runs it
+        spdlog::log_clock::time_point m_deadline = spdlog::log_clock::time_point::max();  ///< Next period boundary
+
+        // Retention and compression of sequential files, guarded by m_retentionMutex
+        struct Rotated {
+            size_t index;
+            uint64_t bytes;  ///< On disk; compressed size once compressed
+        };
+        std::deque<Rotated> m_rotated;  ///< Kept files, oldest first
+        uint64_t m_rotatedBytes = 0;
+        std::deque<size_t> m_compressQueue;
+        std::atomic<bool> m_compressStopping{false};
+        std::mutex m_retentionMutex;
+        std::condition_variable m_compressCv;
+
+        // Asynchronous rotation, guarded by m_rotationMutex
+        std::unique_ptr<FileWriter> m_next;     ///< Open on m_nextPath; empty while the helper prepares it
+        std::unique_ptr<FileWriter> m_retired;  ///< Full file for the helper to close and rename
+        std::string m_rotationError;
+        bool m_rotationPending = false;
+        bool m_stopping = false;
+        std::mutex m_rotationMutex;
+        std::condition_variable m_rotationCv;
+        // Flush timer, guarded by m_flushMutex; m_unflushed by the sink mutex
+        bool m_unflushed = false;
+        bool m_flushPending = false;
+        bool m_flushStopping = false;
+        std::mutex m_flushMutex;
+        std::condition_variable m_flushCv;
+
+        std::thread m_rotator;     ///< Started once everything above exists
+        std::thread m_compressor;  ///< Likewise
+        std::thread m_flusher;     ///< Likewise
+    };
+
+    /**
+     * @brief Colorless stdout sink writing records in large batches
+     *
+     * spdlog's console sinks format colors and fflush() stdout after every
+     * record, which costs a write(2) per line. This sink collects records in
+     * a 64 KB buffer and writes it when it is full, on flush(), and once the
+     * oldest buffered record has waited flushInterval (0 = no timer). The
+     * timer runs on a thread that sleeps while the buffer is empty. Writes
+     * go straight to STDOUT_FILENO, bypassing stdio; a non-blocking stdout
+     * is polled until it accepts the batch.
+     */
+    class BufferedConsoleSink final : public spdlog::sinks::base_sink<std::mutex> {
+    public:
+        explicit BufferedConsoleSink(std::chrono::milliseconds flushInterval)
+            : m_buffer(new char[LoggerConstants::CONSOLE_BUFFER_SIZE]), m_interval(flushInterval) {
+            if (m_interval.count() > 0) {
+                m_flusher = std::thread([this] { flusherLoop(); });
+            }
+        }
+
+        ~BufferedConsoleSink() override {
+            if (m_flusher.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(m_timerMutex);
+                    m_stopping = true;
+                }
+                m_timerCv.notify_all();
+                m_flusher.join();
+            }
+            try {
+                std::lock_guard<std::mutex> lock(mutex_);
+                flush_();
+            } catch (...) {
+                // stdout is gone; nothing left to report to
+            }
+        }
+
+        BufferedConsoleSink(const BufferedConsoleSink&) = delete;
+        BufferedConsoleSink& operator=(const BufferedConsoleSink&) = delete;
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override {
+            m_formatted.clear();
+            formatter_->format(msg, m_formatted);
+            size_t size = m_formatted.size();
+            if (m_fill + size > LoggerConstants::CONSOLE_BUFFER_SIZE) {
+                writeOut(m_buffer.get(), std::exchange(m_fill, 0));
+            }
+            if (size >= LoggerConstants::CONSOLE_BUFFER_SIZE) {
+                writeOut(m_formatted.data(), size);
+                return;
+            }
+            bool wasEmpty = (m_fill == 0);
+            std::memcpy(m_buffer.get() + m_fill, m_formatted.data(), size);
+            m_fill += size;
+            if (wasEmpty && m_flusher.joinable()) {
+                // Start the timer once per batch, not per record
+                {
+                    std::lock_guard<std::mutex> lock(m_timerMutex);
+                    m_pending = true;
+                }
+                m_timerCv.notify_one();
+            }
+        }
+
+        void flush_() override { writeOut(m_buffer.get(), std::exchange(m_fill, 0)); }
+
+    private:
+        void flusherLoop() {
+            std::unique_lock<std::mutex> lock(m_timerMutex);
+            for (;;) {
+                m_timerCv.wait(lock, [this] { return m_pending || m_stopping; });
+                if (m_timerCv.wait_for(lock, m_interval, [this] { return m_stopping; })) {
+                    return;
+                }
+                m_pending = false;
+                lock.unlock();
+                try {
+                    std::lock_guard<std::mutex> sinkLock(mutex_);
+                    flush_();
+                } catch (...) {
+                    // The next record's write reports a broken stdout
+                }
+                lock.lock();
+            }
+        }
+
+        static void writeOut(const char* data, size_t length) {
+            while (length > 0) {
+                ssize_t n = ::write(STDOUT_FILENO, data, length);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        pollfd out{STDOUT_FILENO, POLLOUT, 0};
+                        ::poll(&out, 1, -1);
+                        continue;
+                    }
+                    spdlog::throw_spdlog_ex("Failed writing to stdout", errno);
+                }
+                data += n;
+                length -= static_cast<size_t>(n);
+            }
+        }
+
+        std::unique_ptr<char[]> m_buffer;
+        size_t m_fill = 0;
+        spdlog::memory_buf_t m_formatted;
+        const std::chrono::milliseconds m_interval;
+
+        // Flush timer, guarded by m_timerMutex
+        bool m_pending = false;
+        bool m_stopping = false;
+        std::mutex m_timerMutex;
+        std::condition_variable m_timerCv;
+        std::thread m_flusher;  ///< Started once everything above exists
+    };
+}
+
 class Logger {
 public:
     /**
@@ -82,6 +4635,78 @@ public:
         FATAL = 5     ///< Fatal level for critical errors
     };
 
+    /**
+     * @brief Queue engines available when asyncLogging is enabled
+     */
+    enum class AsyncEngine {
+        THREAD_POOL = 0,  ///< spdlog's shared thread pool (single mutex-protected queue)
+        LANES = 1,        ///< FreshLogger engine with a priority lane for ERROR/FATAL
+        LOCK_FREE = 2,    ///< LANES with a bounded lock-free MPSC queue as the normal lane
+        BYTE_RING = 3     ///< LANES storing variable-length records in a byte ring of queueBytes
+    };
+
+    /**
+     * @brief Page kinds for the built-in engines' queue memory
+     */
+    enum class HugePages {
+        OFF = 0,          ///< Regular pages
+        TRANSPARENT = 1,  ///< Ask for transparent huge pages with madvise(MADV_HUGEPAGE)
+        EXPLICIT = 2      ///< Reserved hugetlb pages (vm.nr_hugepages), else TRANSPARENT
+    };
+
+    /**
+     * @brief How the file sink hands formatted records to the kernel
+     */
+    enum class FileBackend {
+        STDIO = 0,    ///< spdlog's rotating_file_sink (buffered fwrite); write(2) buffer when another option needs FileSink
+        IO_URING = 1, ///< Batched writes from registered buffers submitted through io_uring
+        MMAP = 2,     ///< memcpy into fallocate()d, memory-mapped segments; truncated on close and rotation
+        DIRECT = 3,   ///< O_DIRECT from two aligned buffers, bypassing the page cache; else DONTNEED
+        DONTNEED = 4, ///< Buffered writes evicted with posix_fadvise(DONTNEED) once written back
+        GZIP = 5      ///< Independent gzip members per frame, written on flush; needs FRESHLOGGER_WITH_ZLIB
+    };
+
+    /**
+     * @brief How rotated files are named
+     */
+    enum class RotationNaming {
+        CASCADE = 0,    ///< spdlog's scheme: log.1.txt is the newest and every rotation renames them all
+        SEQUENTIAL = 1  ///< log.N.txt with N increasing; one rename and one unlink per rotation
+    };
+
+    /**
+     * @brief Time boundary that starts a new file in addition to maxFileSize
+     */
+    enum class RotationInterval {
+        NONE = 0,    ///< Rotate on size only
+        HOURLY = 1,  ///< Also at the start of every local hour
+        DAILY = 2    ///< Also at local midnight
+    };
+
+    /**
+     * @brief How console output is written
+     */
+    enum class ConsoleMode {
+        COLOR = 0,    ///< spdlog's color sink: flushed after every record
+        AUTO = 1,     ///< BUFFERED when stdout is not a terminal (pipe, file, /dev/null), else COLOR
+        BUFFERED = 2  ///< No colors; records written to stdout in 64 KB batches
+    };
+
+    /**
+     * @brief What a flush guarantees for the log file
+     *
+     * ERROR and FATAL records flush the sinks as they are written, so that
+     * the records explaining a failure survive it. A flush costs a write(2);
+     * with FDATASYNC it also waits for the disk. Config::groupCommitWindow
+     * lets the errors of a backlog on a built-in engine share one flush
+     * instead of paying for each.
+     */
+    enum class Durability {
+        NONE = 0,      ///< Only the periodic and explicit flushes; nothing is flushed per record
+        FLUSH = 1,     ///< ERROR and above are handed to the kernel (survive a process crash)
+        FDATASYNC = 2  ///< Also fdatasync() the file on every flush (survive a power loss)
+    };
+
     /**
      * @brief Configuration structure for logger setup
      */
@@ -89,24 +4714,149 @@ public:
         std::string logFilePath;           ///< Path to log file (empty for console only)
         LogLevel minLevel;                 ///< Minimum log level to output
         bool consoleOutput;                ///< Enable console output
+        ConsoleMode consoleMode;           ///< Color sink, or batched writes when stdout is not a terminal
         bool asyncLogging;                 ///< Enable asynchronous logging
         size_t maxFileSize;                ///< Maximum file size before rotation (10MB)
         int maxFiles;                      ///< Maximum number of rotated files to keep
         std::string pattern;               ///< Log message pattern
         size_t queueSize;                  ///< Queue size for async logging
-        size_t flushInterval;              ///< Flush interval in seconds
+        size_t flushInterval;              ///< Seconds a record may wait in FreshLogger's file sink or the buffered console; 0 disables
+        AsyncEngine asyncEngine;           ///< Queue engine used for asynchronous logging
+        LogLevel priorityLevel;            ///< Records at or above this level bypass the normal queue, ahead of earlier records (built-in engines)
+        bool crashHandler;                 ///< Drain queued records to the log file on SIGSEGV/SIGABRT/SIGBUS/SIGFPE
+        std::chrono::milliseconds shutdownDeadline; ///< Time the destructor may spend draining the queue (THREAD_POOL: waiting for it)
+        size_t queueShards;                ///< Independent queues producers are spread over (built-in engines)
+        size_t backendWorkers;             ///< Worker threads draining the shards (built-in engines)
+        bool numaAware;                    ///< One node-local queue and pinned worker per NUMA node (built-in engines)
+        bool numaPerNodeFiles;             ///< With numaAware, each node's worker writes <log>.node<N><ext>
+        size_t queueBytes;                 ///< Byte capacity of the BYTE_RING queue (8MB)
+        std::chrono::milliseconds memoryReleaseDelay; ///< Idle time before built-in engines return queue memory (0 = never)
+        HugePages hugePages;               ///< Page kind for built-in engine queues; falls back to regular pages
+        bool slabAllocator;                ///< Queue long payloads in per-thread slabs instead of malloc (LANES, LOCK_FREE)
+        bool autoTuneQueue;                ///< Collect burst statistics and resize the LANES queue between the bounds below
+        size_t autoTuneMinQueueSize;       ///< Smallest capacity auto-tuning shrinks to, in records (1024)
+        size_t autoTuneMaxQueueMemory;     ///< Largest slot memory auto-tuning grows to, in bytes (64MB)
+        bool manualPump;                   ///< No backend worker: the application writes queued records with poll()
+        FileBackend fileBackend;           ///< Write path of the file sink; falls back to STDIO when unavailable
+        bool asyncRotation;                ///< Pre-open the next file and rename rotated ones on a helper thread
+        bool compressRotated;              ///< gzip rotated files in the background; implies SEQUENTIAL naming
+        RotationInterval rotationInterval; ///< Also rotate at each local hour or midnight
+        size_t maxTotalSize;               ///< Delete the oldest rotated files beyond this many bytes; 0 = no cap
+        RotationNaming rotationNaming;     ///< Naming of rotated files; SEQUENTIAL avoids O(maxFiles) renames
+        Durability durability;             ///< What flushes, including the one per ERROR record, guarantee
+        std::chrono::milliseconds groupCommitWindow; ///< Built-in engines: longest a flush waits for a backlog (0 = none)
         
         // Default constructor with default values
         Config() : 
             logFilePath(""),
             minLevel(LogLevel::INFO),
             consoleOutput(true),
+            consoleMode(ConsoleMode::COLOR),
             asyncLogging(false), // Default to sync for better compatibility
             maxFileSize(LoggerConstants::DEFAULT_MAX_FILE_SIZE),
             maxFiles(LoggerConstants::DEFAULT_MAX_FILES),
             pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v"),
             queueSize(LoggerConstants::DEFAULT_QUEUE_SIZE),
-            flushInterval(LoggerConstants::DEFAULT_FLUSH_INTERVAL) {}
+            flushInterval(LoggerConstants::DEFAULT_FLUSH_INTERVAL),
+            asyncEngine(AsyncEngine::THREAD_POOL),
+            priorityLevel(LogLevel::ERROR),
+            crashHandler(false),
+            shutdownDeadline(LoggerConstants::DEFAULT_SHUTDOWN_DEADLINE_MS),
+            queueShards(1),
+            backendWorkers(1),
+            numaAware(false),
+            numaPerNodeFiles(false),
+            queueBytes(LoggerConstants::DEFAULT_QUEUE_BYTES),
+            memoryReleaseDelay(0),
+            hugePages(HugePages::OFF),
+            slabAllocator(false),
+            autoTuneQueue(false),
+            autoTuneMinQueueSize(LoggerConstants::DEFAULT_AUTO_TUNE_MIN_QUEUE_SIZE),
+            autoTuneMaxQueueMemory(LoggerConstants::DEFAULT_AUTO_TUNE_MAX_QUEUE_MEMORY),
+            manualPump(false),
+            fileBackend(FileBackend::STDIO),
+            asyncRotation(false),
+            compressRotated(false),
+            rotationInterval(RotationInterval::NONE),
+            maxTotalSize(0),
+            rotationNaming(RotationNaming::CASCADE),
+            durability(Durability::FLUSH),
+            groupCommitWindow(0) {}
+    };
+
+    /**
+     * @brief Async queue statistics; see queueStats()
+     */
+    using QueueStats = LoggerDetail::QueueStats;
+
+    /**
+     * @brief Lines collected on one thread and published together; see Logger::batch()
+     *
+     * On the built-in engines the lines are queued as a single entry when the
+     * batch goes out of scope: one enqueue and one worker wakeup, and they
+     * appear back to back in the output. Each line keeps the timestamp of its
+     * call. Other configurations write the lines one by one at that point.
+     * A batch belongs to the thread that created it.
+     */
+    class Batch {
+    public:
+        Batch(Batch&& other) noexcept = default;
+        Batch& operator=(Batch&& other) = delete;
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+        ~Batch() { publish(); }
+
+        void info(const std::string& message) { add(spdlog::level::info, message); }
+        void warning(const std::string& message) { add(spdlog::level::warn, message); }
+        void error(const std::string& message) { add(spdlog::level::err, message); }
+        void debug(const std::string& message) { add(spdlog::level::debug, message); }
+        void trace(const std::string& message) { add(spdlog::level::trace, message); }
+        void fatal(const std::string& message) { add(spdlog::level::critical, message); }
+
+        /**
+         * @brief Publish the lines collected so far; the batch can be reused afterwards
+         */
+        void publish() {
+            if (!m_batch) {
+                return;
+            }
+            if (m_engine) {
+                m_engine->postBatch(std::move(m_batch));
+                return;
+            }
+            m_batch->seal();
+            for (const auto& msg : m_batch->messages) {
+                m_logger->log(msg.time, msg.source, msg.level, msg.payload);
+            }
+            m_batch->release();
+            m_batch.reset();
+        }
+
+        /**
+         * @brief Lines collected and not yet published
+         */
+        [[nodiscard]] size_t size() const { return m_batch ? m_batch->messages.size() : 0; }
+
+    private:
+        friend class Logger;
+
+        Batch(std::shared_ptr<spdlog::logger> logger, LoggerDetail::EngineLogger* engine)
+            : m_logger(std::move(logger)), m_engine(engine) {}
+
+        void add(spdlog::level::level_enum level, const std::string& message) {
+            if (!m_logger || !m_logger->should_log(level)) {
+                return;
+            }
+            if (!m_batch) {
+                m_batch = LoggerDetail::RecordBatch::acquire();
+            }
+            m_batch->add(m_logger->name(), level, message);
+        }
+
+        std::shared_ptr<spdlog::logger> m_logger;  ///< Keeps the engine alive until published
+        LoggerDetail::EngineLogger* m_engine;
+        std::shared_ptr<LoggerDetail::RecordBatch> m_batch;
     };
 
     /**
@@ -118,12 +4868,10 @@ public:
     }
     
     /**
-     * @brief Destructor - ensures proper cleanup and flush
+     * @brief Destructor - flushes, draining the async queue for at most Config::shutdownDeadline
      */
     ~Logger() {
-        if (m_logger) {
-            m_logger->flush();
-        }
+        shutdown(m_config.shutdownDeadline);
     }
 
     // Logging methods
@@ -163,6 +4911,82 @@ public:
         }
     }
     
+    /**
+     * @brief Start a batch of lines published together when it goes out of scope
+     * @return Batch scope object, to be used on the calling thread only
+     *
+     * @code
+     * {
+     *     auto batch = logger.batch();
+     *     for (const auto& item : order.items) {
+     *         batch.info("  " + item.describe());
+     *     }
+     * } // one queue entry, lines stay contiguous
+     * @endcode
+     */
+    [[nodiscard]] Batch batch() {
+        return Batch(m_logger, m_engineLogger);
+    }
+
+    /**
+     * @brief Log a range of already formatted lines at one level
+     * @param level Level of every line
+     * @param first,last Forward range of std::string, std::string_view or const char*
+     *
+     * On the built-in engines the whole range is copied into one queue entry
+     * (BYTE_RING: one reservation), with a single timestamp and thread id, and
+     * written back to back like a batch(). Other configurations log the lines
+     * one by one.
+     */
+    template<typename Iterator>
+    void logLines(LogLevel level, Iterator first, Iterator last) {
+        auto spdLevel = convertLevel(level);
+        if (!m_logger || !m_logger->should_log(spdLevel) || first == last) {
+            return;
+        }
+        if (!m_engineLogger) {
+            for (; first != last; ++first) {
+                m_logger->log(spdLevel, spdlog::string_view_t(*first));
+            }
+            return;
+        }
+        auto lines = LoggerDetail::RecordBatch::acquire();
+        lines->addLines(m_logger->name(), spdLevel, first, last);
+        m_engineLogger->postBatch(std::move(lines));
+    }
+
+    /**
+     * @brief Log every line of a container or array; see logLines(LogLevel, Iterator, Iterator)
+     */
+    template<typename Range>
+    void logLines(LogLevel level, const Range& lines) {
+        logLines(level, std::begin(lines), std::end(lines));
+    }
+
+    /**
+     * @brief Write queued records on the calling thread (Config::manualPump)
+     * @param budget Maximum number of queue entries to process; a batch counts once
+     * @return Entries processed, 0 when nothing was queued or not in manual mode
+     *
+     * Call from the application's event loop, typically when eventFd() becomes
+     * readable. Several threads may call it; they take turns. flush(), the
+     * destructor and producers that find the queue full also pump, so nothing
+     * is lost if the loop falls behind.
+     */
+    size_t poll(size_t budget = LoggerConstants::DEFAULT_POLL_BUDGET) {
+        return m_engineLogger ? m_engineLogger->engine().poll(budget) : 0;
+    }
+
+    /**
+     * @brief Descriptor that polls readable while records wait for poll()
+     * @return eventfd owned by the logger, or -1 when not in manual mode
+     *
+     * Register it with epoll/poll/select for reading; poll() resets it.
+     */
+    [[nodiscard]] int eventFd() const {
+        return m_engineLogger ? m_engineLogger->engine().eventFd() : -1;
+    }
+
     /**
      * @brief Set minimum log level
      * @param level New minimum level
@@ -192,6 +5016,107 @@ public:
         }
     }
     
+    /**
+     * @brief Request a flush without waiting for it
+     * @return Future that becomes ready once every earlier record is flushed
+     *
+     * On built-in engines a flush barrier is queued behind the pending records.
+     * On spdlog's THREAD_POOL engine the flush is followed by a marker that
+     * completes the future when the pool thread reaches it. Synchronous
+     * loggers flush before returning.
+     */
+    std::future<void> flushAsync() {
+        return flushAsync(std::function<void()>());
+    }
+    
+    /**
+     * @brief Request a flush and run a callback when it completes
+     * @param callback Invoked once every earlier record is flushed; on async
+     *                 engines it runs on the backend thread and must not block
+     * @return Future that becomes ready after the callback has run
+     */
+    std::future<void> flushAsync(std::function<void()> callback) {
+        if (m_engineLogger) {
+            return m_engineLogger->flushAsync(std::move(callback));
+        }
+        if (m_poolFlush) {
+            return m_poolFlush->flushAsync(*m_logger, std::move(callback));
+        }
+        
+        std::promise<void> done;
+        if (m_logger) {
+            m_logger->flush();
+        }
+        if (callback) {
+            callback();
+        }
+        done.set_value();
+        return done.get_future();
+    }
+    
+    /**
+     * @brief Stop the logger, writing queued records for at most the given time
+     * @param deadline Maximum time spent draining the async queue
+     * @return Number of queued records abandoned when the deadline expired
+     *
+     * Records still queued when the deadline passes are dropped and a warning
+     * with their count is written to the sinks. spdlog's THREAD_POOL engine
+     * cannot drop records from its shared queue: shutdown() waits for them
+     * until the deadline, leaves the rest to spdlog's pool thread and reports
+     * 0. Logging calls after shutdown() are ignored.
+     */
+    size_t shutdown(std::chrono::milliseconds deadline) {
+        size_t abandoned = 0;
+        if (m_engineLogger) {
+            abandoned = m_engineLogger->shutdown(deadline);
+        } else if (m_poolFlush) {
+            // spdlog's queue cannot be trimmed: wait for our records until the
+            // deadline and leave the rest to the pool thread, which closes the
+            // sinks once it has written them
+            auto until = (deadline < std::chrono::hours(24 * 365))
+                ? std::chrono::steady_clock::now() + deadline
+                : std::chrono::steady_clock::time_point::max();
+            while (!m_poolFlush->hasRoom() && std::chrono::steady_clock::now() < until) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (m_poolFlush->hasRoom()) {
+                auto done = m_poolFlush->flushAsync(*m_logger, nullptr);
+                if (until == std::chrono::steady_clock::time_point::max()) {
+                    done.wait();
+                } else {
+                    done.wait_until(until);
+                }
+            }
+        } else if (m_logger) {
+            m_logger->flush();
+        }
+        m_engineLogger = nullptr;
+        m_poolFlush.reset();
+        m_logger.reset();
+        return abandoned;
+    }
+    
+    /**
+     * @brief Async queue statistics and the queueSize they recommend
+     * @return Full statistics on LANES and LOCK_FREE with Config::autoTuneQueue;
+     *         otherwise only the capacity, which is also the recommendation
+     *
+     * recommendedQueueSize is the static Config::queueSize that would have
+     * held the deepest burst seen so far with a quarter to spare, so a run with
+     * auto-tuning under representative load can be used to pick a fixed size.
+     */
+    [[nodiscard]] QueueStats queueStats() const {
+        if (m_engineLogger) {
+            return m_engineLogger->engine().stats();
+        }
+        QueueStats stats;
+        if (m_logger && m_config.asyncLogging) {
+            stats.capacity = m_config.queueSize;
+            stats.recommendedQueueSize = m_config.queueSize;
+        }
+        return stats;
+    }
+    
     /**
      * @brief Get underlying spdlog logger instance
      * @return Shared pointer to spdlog logger
@@ -206,9 +5131,7 @@ private:
         
         // Console sink setup
         if (config.consoleOutput) {
-            auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-            console_sink->set_level(convertLevel(config.minLevel));
-            sinks.push_back(console_sink);
+            sinks.push_back(makeConsoleSink(config));
         }
         
         // File sink setup
@@ -250,20 +5173,14 @@ private:
                         std::cerr << "Warning: Log directory not writable: " << logDir << " - " << ex.what() << '\n';
                         // Fall back to console only
                         if (sinks.empty()) {
-                            auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-                            console_sink->set_level(convertLevel(config.minLevel));
-                            sinks.push_back(console_sink);
+                            sinks.push_back(makeConsoleSink(config));
                         }
                         return; // Skip file sink creation
                     }
                 }
                 
                 // Create rotating file sink with custom error handling
-                auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-                    config.logFilePath, 
-                    config.maxFileSize, 
-                    config.maxFiles
-                );
+                auto file_sink = makeFileSink(config, config.logFilePath);
                 file_sink->set_level(convertLevel(config.minLevel));
                 
                 sinks.push_back(file_sink);
@@ -275,27 +5192,66 @@ private:
                 std::cerr << "Warning: Could not create log file: " << config.logFilePath 
                           << " - " << ex.what() << '\n';
                 if (sinks.empty()) {
-                    auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-                    console_sink->set_level(convertLevel(config.minLevel));
-                    sinks.push_back(console_sink);
+                    sinks.push_back(makeConsoleSink(config));
                 }
             }
         }
         
         // Ensure at least one sink exists
         if (sinks.empty()) {
-            auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-            console_sink->set_level(convertLevel(config.minLevel));
-            sinks.push_back(console_sink);
+            sinks.push_back(makeConsoleSink(config));
         }
         
         // Create logger based on configuration
-        if (config.asyncLogging) {
+        // (spdlog's thread pool queue is unreachable from a signal handler, so the
+        // crash handler always runs on a built-in engine; so does manual pumping)
+        if (config.asyncLogging && (config.asyncEngine != AsyncEngine::THREAD_POOL || config.crashHandler || config.manualPump)) {
+            // FreshLogger queue engine with its own backend worker
+            LoggerDetail::EngineOptions options;
+            options.queueSize = config.queueSize;
+            options.priorityLevel = convertLevel(config.priorityLevel);
+            options.lockFree = (config.asyncEngine == AsyncEngine::LOCK_FREE);
+            options.byteRing = (config.asyncEngine == AsyncEngine::BYTE_RING);
+            options.queueBytes = config.queueBytes;
+            options.releaseAfter = config.memoryReleaseDelay;
+            options.pages = convertHugePages(config.hugePages);
+            options.slab = config.slabAllocator;
+            options.autoTune = config.autoTuneQueue;
+            options.autoTuneMinSize = config.autoTuneMinQueueSize;
+            options.autoTuneMaxBytes = config.autoTuneMaxQueueMemory;
+            options.shards = config.queueShards;
+            options.workers = config.backendWorkers;
+            options.numa = config.numaAware;
+            options.manual = config.manualPump;
+            options.commitWindow = std::max(config.groupCommitWindow, std::chrono::milliseconds(0));
+            if (config.numaAware && config.numaPerNodeFiles) {
+                splitFileSinkPerNode(config, sinks, options.workerSinks);
+            }
+            options.crashHandler = config.crashHandler;
+            options.crashLogPath = crashLogPath(config);
+            
+            auto engine_logger = std::make_shared<LoggerDetail::EngineLogger>(
+                "async_logger_" + std::to_string(reinterpret_cast<uintptr_t>(this)),
+                sinks.begin(),
+                sinks.end(),
+                options
+            );
+            
+            engine_logger->set_level(convertLevel(config.minLevel));
+            engine_logger->set_pattern(config.pattern);
+            engine_logger->flush_on(flushLevel(config.durability));
+            
+            m_logger = engine_logger;
+            m_engineLogger = engine_logger.get();
+            m_poolFlush.reset();
+        } else if (config.asyncLogging) {
             // Initialize async thread pool if not already done
             static bool thread_pool_initialized = false;
+            static size_t thread_pool_capacity = 0;
             if (!thread_pool_initialized) {
                 spdlog::init_thread_pool(config.queueSize, 1);
                 thread_pool_initialized = true;
+                thread_pool_capacity = config.queueSize;
             }
             
             // Asynchronous logger for better performance
@@ -309,9 +5265,11 @@ private:
             
             async_logger->set_level(convertLevel(config.minLevel));
             async_logger->set_pattern(config.pattern);
-            async_logger->flush_on(spdlog::level::err);
+            async_logger->flush_on(flushLevel(config.durability));
             
             m_logger = async_logger;
+            m_engineLogger = nullptr;
+            m_poolFlush = std::make_unique<LoggerDetail::PoolFlush>(async_logger->name(), thread_pool_capacity);
         } else {
             // Synchronous logger for simple use cases
             auto sync_logger = std::make_shared<spdlog::logger>(
@@ -322,12 +5280,147 @@ private:
             
             sync_logger->set_level(convertLevel(config.minLevel));
             sync_logger->set_pattern(config.pattern);
-            sync_logger->flush_on(spdlog::level::err);
+            sync_logger->flush_on(flushLevel(config.durability));
             
             m_logger = sync_logger;
+            m_engineLogger = nullptr;
+            m_poolFlush.reset();
+        }
+    }
+    
+    [[nodiscard]] static spdlog::level::level_enum flushLevel(Durability durability) {
+        return durability == Durability::NONE ? spdlog::level::off : spdlog::level::err;
+    }
+    
+    /**
+     * @brief File the crash handler appends drained records to
+     *
+     * Plain text appended after gzip members would corrupt the stream, so a
+     * GZIP log gets a plain "<logFilePath>.crash" file next to it.
+     */
+    [[nodiscard]] static std::string crashLogPath(const Config& config) {
+#ifdef FRESHLOGGER_WITH_ZLIB
+        if (config.fileBackend == FileBackend::GZIP) {
+            return config.logFilePath + ".crash";
         }
+#endif
+        return config.logFilePath;
     }
     
+    [[nodiscard]] static LoggerDetail::RotationPeriod convertRotationInterval(RotationInterval interval) {
+        switch (interval) {
+            case RotationInterval::HOURLY: return LoggerDetail::RotationPeriod::HOURLY;
+            case RotationInterval::DAILY:  return LoggerDetail::RotationPeriod::DAILY;
+            default:                       return LoggerDetail::RotationPeriod::NONE;
+        }
+    }
+    
+    [[nodiscard]] static LoggerDetail::PageMode convertHugePages(HugePages hugePages) {
+        switch (hugePages) {
+            case HugePages::TRANSPARENT: return LoggerDetail::PageMode::TRANSPARENT_HUGE;
+            case HugePages::EXPLICIT:    return LoggerDetail::PageMode::EXPLICIT_HUGE;
+            default:                     return LoggerDetail::PageMode::NORMAL;
+        }
+    }
+    
+    /**
+     * @brief Replace the shared file sink with one file per NUMA node
+     * @param config Logger configuration
+     * @param sinks Shared sinks; the rotating file sink is removed from it
+     * @param nodeSinks Receives one sink per node, in NumaTopology::nodes order
+     */
+    static void splitFileSinkPerNode(const Config& config,
+                                     std::vector<spdlog::sink_ptr>& sinks,
+                                     std::vector<spdlog::sink_ptr>& nodeSinks) {
+        auto fileSink = std::find_if(sinks.begin(), sinks.end(), [](const spdlog::sink_ptr& sink) {
+            return std::dynamic_pointer_cast<spdlog::sinks::rotating_file_sink_mt>(sink) != nullptr ||
+                   std::dynamic_pointer_cast<LoggerDetail::FileSink>(sink) != nullptr;
+        });
+        if (fileSink == sinks.end()) {
+            return;
+        }
+        sinks.erase(fileSink);
+        
+        std::filesystem::path logPath(config.logFilePath);
+        for (const auto& node : LoggerDetail::NumaTopology::system().nodes) {
+            auto nodePath = logPath.parent_path() /
+                (logPath.stem().string() + ".node" + std::to_string(node.id) + logPath.extension().string());
+            auto node_sink = makeFileSink(config, nodePath.string());
+            node_sink->set_level(convertLevel(config.minLevel));
+            node_sink->set_pattern(config.pattern);
+            nodeSinks.push_back(node_sink);
+        }
+    }
+    
+    /**
+     * @brief Stdout sink for the configured consoleMode
+     */
+    [[nodiscard]] static spdlog::sink_ptr makeConsoleSink(const Config& config) {
+        spdlog::sink_ptr sink;
+        if (config.consoleMode == ConsoleMode::BUFFERED ||
+            (config.consoleMode == ConsoleMode::AUTO && ::isatty(STDOUT_FILENO) == 0)) {
+            sink = std::make_shared<LoggerDetail::BufferedConsoleSink>(std::chrono::seconds(config.flushInterval));
+        } else {
+            sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        }
+        sink->set_level(convertLevel(config.minLevel));
+        return sink;
+    }
+    
+    /**
+     * @brief Rotating file sink for the configured backend
+     * @param config Logger configuration (fileBackend, asyncRotation, rotationNaming, compressRotated,
+     *               rotationInterval, maxFileSize, maxFiles, maxTotalSize, durability, flushInterval)
+     * @param path File to write
+     *
+     * Backends the kernel does not support fall back to spdlog's rotating sink.
+     */
+    [[nodiscard]] static spdlog::sink_ptr makeFileSink(const Config& config, const std::string& path) {
+        size_t maxFiles = static_cast<size_t>(std::max(config.maxFiles, 0));
+        LoggerDetail::FileSinkOptions options;
+        options.maxSize = config.maxFileSize;
+        options.maxFiles = maxFiles;
+        options.asyncRotation = config.asyncRotation;
+        options.sequentialNames = (config.rotationNaming == RotationNaming::SEQUENTIAL || config.compressRotated);
+        options.compress = config.compressRotated && config.fileBackend != FileBackend::GZIP;
+        options.period = convertRotationInterval(config.rotationInterval);
+        options.maxTotalSize = config.maxTotalSize;
+        options.sync = (config.durability == Durability::FDATASYNC);
+        options.flushInterval = std::chrono::seconds(config.flushInterval);
+        auto fileSink = [&](LoggerDetail::FileSink::WriterFactory factory) {
+            return std::make_shared<LoggerDetail::FileSink>(path, options, std::move(factory));
+        };
+#ifdef FRESHLOGGER_HAS_IO_URING
+        if (config.fileBackend == FileBackend::IO_URING && LoggerDetail::IoUring::available()) {
+            try {
+                return fileSink([] { return std::make_unique<LoggerDetail::UringWriter>(); });
+            } catch (const spdlog::spdlog_ex&) {
+                // Ring creation refused (e.g. memory limits): use the stdio path
+            }
+        }
+#endif
+        if (config.fileBackend == FileBackend::MMAP) {
+            size_t segment = std::min(config.maxFileSize, LoggerConstants::MMAP_SEGMENT_SIZE);
+            return fileSink([segment] { return std::make_unique<LoggerDetail::MmapWriter>(segment); });
+        }
+        if (config.fileBackend == FileBackend::DIRECT && LoggerDetail::DirectWriter::supported(path)) {
+            return fileSink([] { return std::make_unique<LoggerDetail::DirectWriter>(); });
+        }
+        if (config.fileBackend == FileBackend::DIRECT || config.fileBackend == FileBackend::DONTNEED) {
+            return fileSink([] { return std::make_unique<LoggerDetail::DropCacheWriter>(); });
+        }
+#ifdef FRESHLOGGER_WITH_ZLIB
+        if (config.fileBackend == FileBackend::GZIP) {
+            return fileSink([] { return std::make_unique<LoggerDetail::GzipWriter>(); });
+        }
+#endif
+        if (options.asyncRotation || options.sequentialNames || options.period != LoggerDetail::RotationPeriod::NONE ||
+            options.maxTotalSize > 0 || options.sync) {
+            return fileSink([] { return std::make_unique<LoggerDetail::BufferedWriter>(); });
+        }
+        return std::make_shared<spdlog::sinks::rotating_file_sink_mt>(path, config.maxFileSize, maxFiles);
+    }
+
     [[nodiscard]] static spdlog::level::level_enum convertLevel(LogLevel level) {
         switch (level) {
             case LogLevel::TRACE:   return spdlog::level::trace;
@@ -343,6 +5436,8 @@ private:
 
     
     std::shared_ptr<spdlog::logger> m_logger;  ///< Underlying spdlog logger instance
+    LoggerDetail::EngineLogger* m_engineLogger = nullptr; ///< Set when m_logger runs on a built-in engine
+    std::unique_ptr<LoggerDetail::PoolFlush> m_poolFlush; ///< Set when m_logger runs on spdlog's thread pool
     Config m_config;                           ///< Current logger configuration
 };
 
@@ -7,10 +7,19 @@
 #include "Logger.hpp"
 #include <gtest/gtest.h>
 #include <filesystem>
+#include <algorithm>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 #include <thread>
 #include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 class LoggerTest : public ::testing::Test {
 protected:
@@ -44,6 +53,45 @@ protected:
         std::string content = readLogFile(filename);
         return content.find(message) != std::string::npos;
     }
+    
+    // A "<thread> <index> [rest]" line written by one of several producer threads
+    struct ProducerLine {
+        int thread = -1;
+        int index = -1;
+        std::string rest;
+    };
+    
+    // Read producer lines, checking that each thread's indices count up from 0;
+    // lines in another format go to others, or fail the test when it is null
+    std::vector<ProducerLine> readProducerLines(const std::string& filename, int numThreads,
+                                                std::vector<std::string>* others = nullptr) {
+        std::ifstream file(filename);
+        std::vector<ProducerLine> lines;
+        std::vector<int> next(static_cast<size_t>(numThreads), 0);
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            ProducerLine parsed;
+            if (!(fields >> parsed.thread >> parsed.index)) {
+                if (others != nullptr) {
+                    others->push_back(line);
+                } else {
+                    ADD_FAILURE() << "Unexpected line: " << line.substr(0, 80);
+                }
+                continue;
+            }
+            if (parsed.thread < 0 || parsed.thread >= numThreads) {
+                ADD_FAILURE() << "No such producer: " << line.substr(0, 80);
+                continue;
+            }
+            fields >> std::ws;
+            std::getline(fields, parsed.rest);
+            EXPECT_EQ(parsed.index, next[static_cast<size_t>(parsed.thread)]) << "Records of one producer must stay in order";
+            next[static_cast<size_t>(parsed.thread)] = parsed.index + 1;
+            lines.push_back(std::move(parsed));
+        }
+        return lines;
+    }
 };
 
 // Test 1: Default constructor
@@ -355,6 +403,1637 @@ TEST_F(LoggerTest, PatternFormatting) {
     EXPECT_FALSE(content.find("[%l]") != std::string::npos); // Raw pattern olmamalı
 }
 
+// Test 12: Crash handler drains the async queue before the process dies
+TEST_F(LoggerTest, CrashHandlerDrainsQueue) {
+    const int records = 2000;
+    const int signals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE};
+    
+    for (int sig : signals) {
+        std::string path = "test_logs/crash_" + std::to_string(sig) + ".log";
+        
+        pid_t pid = fork();
+        ASSERT_NE(pid, -1);
+        if (pid == 0) {
+            // Child: fill the queue and crash without flushing
+            struct rlimit noCore = {0, 0};
+            setrlimit(RLIMIT_CORE, &noCore);
+            
+            Logger::Config config;
+            config.logFilePath = path;
+            config.consoleOutput = false;
+            config.asyncLogging = true;
+            config.crashHandler = true;
+            config.queueSize = records * 2;
+            
+            Logger logger(config);
+            for (int i = 0; i < records; ++i) {
+                logger.info("Crash record " + std::to_string(i));
+            }
+            raise(sig);
+            _exit(0);
+        }
+        
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        EXPECT_TRUE(WIFSIGNALED(status)) << "Child should die from the re-raised signal";
+        if (WIFSIGNALED(status)) {
+            EXPECT_EQ(WTERMSIG(status), sig);
+        }
+        
+        // Every record must be in the file exactly once
+        std::ifstream file(path);
+        std::string line;
+        int found = 0;
+        while (std::getline(file, line)) {
+            if (line.find("Crash record ") != std::string::npos) {
+                ++found;
+            }
+        }
+        EXPECT_EQ(found, records) << "Signal " << sig << " lost queued records";
+    }
+}
+
+// Test 13: Lock-free engine delivers every record in per-thread order
+TEST_F(LoggerTest, LockFreeEngineDelivery) {
+    Logger::Config config;
+    config.logFilePath = "test_logs/lock_free.log";
+    config.consoleOutput = false;
+    config.asyncLogging = true;
+    config.asyncEngine = Logger::AsyncEngine::LOCK_FREE;
+    config.queueSize = 64; // Small queue so producers hit the full path
+    config.pattern = "%v";
+    
+    const int numThreads = 4;
+    const int messagesPerThread = 2000;
+    {
+        Logger logger(config);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&logger, t]() {
+                for (int i = 0; i < messagesPerThread; ++i) {
+                    logger.info(std::to_string(t) + " " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.flush();
+    }
+    
+    auto lines = readProducerLines(config.logFilePath, numThreads);
+    EXPECT_EQ(lines.size(), static_cast<size_t>(numThreads * messagesPerThread));
+}
+
+// Test 14: Sharded engine keeps per-thread order and flush() covers every shard
+TEST_F(LoggerTest, ShardedEngineDelivery) {
+    Logger::Config config;
+    config.logFilePath = "test_logs/sharded.log";
+    config.consoleOutput = false;
+    config.asyncLogging = true;
+    config.asyncEngine = Logger::AsyncEngine::LANES;
+    config.queueShards = 4;
+    config.backendWorkers = 2;
+    config.queueSize = 64; // 16 slots per shard so producers hit the full path
+    config.pattern = "%v";
+    
+    const int numThreads = 6;
+    const int messagesPerThread = 2000;
+    Logger logger(config);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&logger, t]() {
+            for (int i = 0; i < messagesPerThread; ++i) {
+                logger.info(std::to_string(t) + " " + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+    
+    // Checked before the logger is destroyed: the flush barrier alone must
+    // have pushed every shard to disk
+    auto lines = readProducerLines(config.logFilePath, numThreads);
+    EXPECT_EQ(lines.size(), static_cast<size_t>(numThreads * messagesPerThread));
+}
+
+// Test 15: NUMA mode writes every record once across the per-node files
+TEST_F(LoggerTest, NumaPerNodeFiles) {
+    Logger::Config config;
+    config.logFilePath = "test_logs/numa.log";
+    config.consoleOutput = false;
+    config.asyncLogging = true;
+    config.asyncEngine = Logger::AsyncEngine::LANES;
+    config.numaAware = true;
+    config.numaPerNodeFiles = true;
+    config.pattern = "%v";
+    
+    const auto& nodes = LoggerDetail::NumaTopology::system().nodes;
+    ASSERT_FALSE(nodes.empty());
+    
+    const int messagesPerNode = 1000;
+    {
+        Logger logger(config);
+        std::vector<std::thread> threads;
+        for (size_t n = 0; n < nodes.size(); ++n) {
+            threads.emplace_back([&logger, n]() {
+                LoggerDetail::NumaTopology::system().pinToNode(n);
+                for (int i = 0; i < messagesPerNode; ++i) {
+                    logger.info("numa " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.flush();
+    }
+    
+    int total = 0;
+    for (const auto& node : nodes) {
+        std::ifstream file("test_logs/numa.node" + std::to_string(node.id) + ".log");
+        EXPECT_TRUE(file.is_open()) << "Missing file for node " << node.id;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.rfind("numa ", 0) == 0) {
+                ++total;
+            }
+        }
+    }
+    EXPECT_EQ(total, static_cast<int>(nodes.size()) * messagesPerNode);
+}
+
+// Test 16: Byte-ring engine keeps order, truncates oversized records and drains on crash
+TEST_F(LoggerTest, ByteRingEngine) {
+    Logger::Config config;
+    config.logFilePath = "test_logs/byte_ring.log";
+    config.consoleOutput = false;
+    config.asyncLogging = true;
+    config.asyncEngine = Logger::AsyncEngine::BYTE_RING;
+    config.queueBytes = 16 * 1024; // A few records at a time, so the ring wraps constantly
+    config.pattern = "%v";
+    
+    const int numThreads = 4;
+    const int messagesPerThread = 1000;
+    {
+        Logger logger(config);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&logger, t]() {
+                for (int i = 0; i < messagesPerThread; ++i) {
+                    logger.info(std::to_string(t) + " " + std::to_string(i) + " " +
+                                std::string(static_cast<size_t>((i * 37) % 3000), 'x'));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.info("oversized " + std::string(100000, 'y'));
+        logger.flush();
+    }
+    
+    std::vector<std::string> others;
+    auto lines = readProducerLines(config.logFilePath, numThreads, &others);
+    EXPECT_EQ(lines.size(), static_cast<size_t>(numThreads * messagesPerThread));
+    for (const auto& line : lines) {
+        EXPECT_EQ(line.rest.size(), static_cast<size_t>((line.index * 37) % 3000)) << "Payload corrupted";
+    }
+    ASSERT_EQ(others.size(), 1U) << "Oversized record should be written truncated";
+    EXPECT_EQ(others[0].rfind("oversized ", 0), 0U);
+    EXPECT_LE(others[0].size(), config.queueBytes);
+    
+    // Crash drain walks the ring without copying records out
+    std::string crashPath = "test_logs/byte_ring_crash.log";
+    const int records = 500;
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        struct rlimit noCore = {0, 0};
+        setrlimit(RLIMIT_CORE, &noCore);
+        Logger::Config crashConfig = config;
+        crashConfig.logFilePath = crashPath;
+        crashConfig.crashHandler = true;
+        crashConfig.queueBytes = 1024 * 1024;
+        Logger logger(crashConfig);
+        for (int i = 0; i < records; ++i) {
+            logger.info("Crash record " + std::to_string(i));
+        }
+        raise(SIGSEGV);
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFSIGNALED(status));
+    std::ifstream crashFile(crashPath);
+    std::string line;
+    int found = 0;
+    while (std::getline(crashFile, line)) {
+        if (line.find("Crash record ") != std::string::npos) {
+            ++found;
+        }
+    }
+    EXPECT_EQ(found, records);
+}
+
+// Test 17: Huge-page queues work, falling back to regular pages when refused
+TEST_F(LoggerTest, HugePageQueues) {
+    const Logger::AsyncEngine engines[] = {
+        Logger::AsyncEngine::LANES, Logger::AsyncEngine::LOCK_FREE, Logger::AsyncEngine::BYTE_RING};
+    const Logger::HugePages modes[] = {Logger::HugePages::TRANSPARENT, Logger::HugePages::EXPLICIT};
+    
+    for (auto engine : engines) {
+        for (auto mode : modes) {
+            std::string path = "test_logs/huge_" + std::to_string(static_cast<int>(engine)) + "_" +
+                               std::to_string(static_cast<int>(mode)) + ".log";
+            Logger::Config config;
+            config.logFilePath = path;
+            config.consoleOutput = false;
+            config.asyncLogging = true;
+            config.asyncEngine = engine;
+            config.hugePages = mode;
+            config.queueSize = 4096;
+            config.queueBytes = 4 * 1024 * 1024;
+            config.pattern = "%v";
+            {
+                Logger logger(config);
+                for (int i = 0; i < 1000; ++i) {
+                    logger.info("Huge page record " + std::to_string(i));
+                }
+                logger.flush();
+            }
+            
+            std::ifstream file(path);
+            std::string line;
+            int count = 0;
+            while (std::getline(file, line)) {
+                EXPECT_EQ(line, "Huge page record " + std::to_string(count));
+                ++count;
+            }
+            EXPECT_EQ(count, 1000) << "Engine " << static_cast<int>(engine) << ", mode " << static_cast<int>(mode);
+        }
+    }
+}
+
+// Test 18: Slab-allocated payloads survive their producer threads and arrive intact
+TEST_F(LoggerTest, SlabAllocatorPayloads) {
+    Logger::Config config;
+    config.logFilePath = "test_logs/slab.log";
+    config.consoleOutput = false;
+    config.asyncLogging = true;
+    config.asyncEngine = Logger::AsyncEngine::LANES;
+    config.slabAllocator = true;
+    config.queueSize = 256;
+    config.pattern = "%v";
+    
+    const int numThreads = 4;
+    const int messagesPerThread = 500;
+    auto paddingFor = [](int thread, int index) {
+        return static_cast<size_t>((thread * 977 + index * 131) % 10000); // Inline, slab and heap sizes
+    };
+    {
+        Logger logger(config);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&logger, &paddingFor, t]() {
+                for (int i = 0; i < messagesPerThread; ++i) {
+                    logger.info(std::to_string(t) + " " + std::to_string(i) + " " +
+                                std::string(paddingFor(t, i), static_cast<char>('a' + t)));
+                }
+            });
+        }
+        // Producers exit while their blocks may still be queued
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.flush();
+    }
+    
+    auto lines = readProducerLines(config.logFilePath, numThreads);
+    EXPECT_EQ(lines.size(), static_cast<size_t>(numThreads * messagesPerThread));
+    for (const auto& line : lines) {
+        EXPECT_EQ(line.rest, std::string(paddingFor(line.thread, line.index), static_cast<char>('a' + line.thread)));
+    }
+}
+
+// Test 19: Auto-tuning grows a queue producers had to wait on and keeps every record
+TEST_F(LoggerTest, AutoTuneQueue) {
+    // Resizing keeps queued records in order and refuses to drop any
+    {
+        LoggerDetail::RingQueue queue(8);
+        for (int i = 0; i < 6; ++i) {
+            LoggerDetail::QueuedRecord record(spdlog::details::log_msg(spdlog::string_view_t{}, spdlog::level::info,
+                                                                       std::to_string(i)));
+            ASSERT_TRUE(queue.tryPush(std::move(record)));
+        }
+        EXPECT_FALSE(queue.resize(4));
+        ASSERT_TRUE(queue.resize(32));
+        EXPECT_EQ(queue.capacity(), 32U);
+        LoggerDetail::QueuedRecord record;
+        for (int i = 0; i < 6; ++i) {
+            ASSERT_TRUE(queue.tryPop(record));
+            EXPECT_EQ(std::string(record.payload.data(), record.payload.size()), std::to_string(i));
+        }
+        EXPECT_TRUE(queue.empty());
+    }
+    
+    for (auto engine : {Logger::AsyncEngine::LANES, Logger::AsyncEngine::LOCK_FREE}) {
+        Logger::Config config;
+        config.logFilePath = "test_logs/auto_tune.log";
+        config.consoleOutput = false;
+        config.asyncLogging = true;
+        config.asyncEngine = engine;
+        config.queueSize = 64;
+        config.autoTuneQueue = true;
+        config.autoTuneMinQueueSize = 64;
+        config.pattern = "%v";
+        std::filesystem::remove(config.logFilePath);
+        
+        const int numThreads = 4;
+        const int messagesPerThread = 5000;
+        Logger::QueueStats stats;
+        {
+            Logger logger(config);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < numThreads; ++t) {
+                threads.emplace_back([&logger, t]() {
+                    for (int i = 0; i < messagesPerThread; ++i) {
+                        logger.info("Burst " + std::to_string(t) + " " + std::to_string(i));
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            logger.flush();
+            // Let the idle worker close its statistics window
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            stats = logger.queueStats();
+        }
+        
+        EXPECT_GT(stats.highWaterMark, 0U);
+        EXPECT_GT(stats.arrivalRatePeak, 0.0);
+        EXPECT_GE(stats.arrivalRatePeak, stats.arrivalRateP99);
+        EXPECT_GE(stats.arrivalRateP99, stats.arrivalRateMedian);
+        EXPECT_GE(stats.recommendedQueueSize, 64U);
+        EXPECT_LE(stats.recommendedQueueSize * sizeof(LoggerDetail::QueuedRecord), config.autoTuneMaxQueueMemory);
+        if (engine == Logger::AsyncEngine::LOCK_FREE) {
+            EXPECT_EQ(stats.capacity, 64U) << "Lock-free queues keep their size";
+            EXPECT_EQ(stats.resizes, 0U);
+        } else if (stats.blockedPushes > 0) {
+            EXPECT_GT(stats.capacity, 64U) << "Waiting producers should grow the queue";
+            EXPECT_GT(stats.resizes, 0U);
+        }
+        
+        std::ifstream file(config.logFilePath);
+        std::string line;
+        int lines = 0;
+        while (std::getline(file, line)) {
+            ++lines;
+        }
+        EXPECT_EQ(lines, numThreads * messagesPerThread);
+    }
+}
+
+// Test 20: Batched lines are written back to back and filtered by level
+TEST_F(LoggerTest, BatchScope) {
+    for (auto engine : {Logger::AsyncEngine::LANES, Logger::AsyncEngine::LOCK_FREE, Logger::AsyncEngine::BYTE_RING}) {
+        Logger::Config config;
+        config.logFilePath = "test_logs/batch.log";
+        config.consoleOutput = false;
+        config.asyncLogging = true;
+        config.asyncEngine = engine;
+        config.queueSize = 64;
+        config.queueBytes = 64 * 1024;
+        config.pattern = "%v";
+        std::filesystem::remove(config.logFilePath);
+        
+        const int numThreads = 4;
+        const int batchesPerThread = 200;
+        const int linesPerBatch = 20;
+        {
+            Logger logger(config);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < numThreads; ++t) {
+                threads.emplace_back([&logger, t]() {
+                    for (int b = 0; b < batchesPerThread; ++b) {
+                        logger.info("single " + std::to_string(t));
+                        auto batch = logger.batch();
+                        for (int l = 0; l < linesPerBatch; ++l) {
+                            std::string line = "batch " + std::to_string(t) + " " + std::to_string(b) + " " +
+                                               std::to_string(l);
+                            // Every tenth batch carries an error and takes the priority lane
+                            if (b % 10 == 0 && l == linesPerBatch - 1) {
+                                batch.error(line);
+                            } else {
+                                batch.info(line);
+                            }
+                            batch.debug("filtered");
+                        }
+                        EXPECT_EQ(batch.size(), static_cast<size_t>(linesPerBatch));
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            logger.flush();
+        }
+        
+        std::ifstream file(config.logFilePath);
+        std::string line;
+        int singles = 0;
+        int batches = 0;
+        int expectedLine = 0;
+        std::string current;
+        while (std::getline(file, line)) {
+            EXPECT_NE(line, "filtered");
+            std::istringstream fields(line);
+            std::string kind;
+            fields >> kind;
+            if (kind == "single") {
+                EXPECT_EQ(expectedLine, 0) << "Line inside a batch at " << current;
+                ++singles;
+                continue;
+            }
+            std::string thread;
+            std::string index;
+            int lineNumber = -1;
+            fields >> thread >> index >> lineNumber;
+            if (expectedLine == 0) {
+                current = thread + " " + index;
+            }
+            EXPECT_EQ(thread + " " + index, current) << "Batch lines must stay contiguous";
+            EXPECT_EQ(lineNumber, expectedLine);
+            expectedLine = (lineNumber + 1) % linesPerBatch;
+            if (expectedLine == 0) {
+                ++batches;
+            }
+        }
+        EXPECT_EQ(singles, numThreads * batchesPerThread);
+        EXPECT_EQ(batches, numThreads * batchesPerThread);
+    }
+    
+    // Without a built-in engine the lines are written when the batch ends
+    Logger::Config config;
+    config.logFilePath = "test_logs/batch_sync.log";
+    config.consoleOutput = false;
+    config.pattern = "%v";
+    {
+        Logger logger(config);
+        auto batch = logger.batch();
+        batch.info("first");
+        batch.warning("second");
+        batch.publish();
+        EXPECT_EQ(batch.size(), 0U);
+        batch.info("third");
+    }
+    std::ifstream file(config.logFilePath);
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    EXPECT_EQ(lines, (std::vector<std::string>{"first", "second", "third"}));
+}
+
+// Test 21: Bulk ranges of preformatted lines arrive complete and in order
+TEST_F(LoggerTest, BulkLines) {
+    auto readLines = [](const std::string& path) {
+        std::ifstream file(path);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    };
+    
+    std::vector<std::string> relayed;
+    for (int i = 0; i < 2000; ++i) {
+        relayed.push_back("child[" + std::to_string(i % 7) + "] line " + std::to_string(i));
+    }
+    std::vector<std::string_view> views(relayed.begin(), relayed.end());
+    const char* literals[] = {"alpha", "beta", "gamma"};
+    
+    // The synchronous logger writes the lines one by one
+    struct Variant {
+        bool async;
+        Logger::AsyncEngine engine;
+    };
+    for (const Variant& variant : {Variant{true, Logger::AsyncEngine::LANES}, Variant{true, Logger::AsyncEngine::BYTE_RING},
+                                   Variant{false, Logger::AsyncEngine::LANES}}) {
+        Logger::Config config;
+        config.logFilePath = "test_logs/bulk.log";
+        config.consoleOutput = false;
+        config.asyncLogging = variant.async;
+        config.asyncEngine = variant.engine;
+        config.queueBytes = 16 * 1024; // Smaller than the range: copied in pieces
+        config.pattern = "%v";
+        std::filesystem::remove(config.logFilePath);
+        {
+            Logger logger(config);
+            logger.logLines(Logger::LogLevel::INFO, relayed);
+            logger.logLines(Logger::LogLevel::DEBUG, views.begin(), views.end()); // Below minLevel
+            logger.logLines(Logger::LogLevel::WARNING, views.begin(), views.begin() + 10);
+            logger.logLines(Logger::LogLevel::ERROR, literals);
+            logger.logLines(Logger::LogLevel::INFO, views.end(), views.end());
+            logger.flush();
+        }
+        
+        std::vector<std::string> expected(relayed);
+        expected.insert(expected.end(), relayed.begin(), relayed.begin() + 10);
+        expected.insert(expected.end(), std::begin(literals), std::end(literals));
+        auto lines = readLines(config.logFilePath);
+        // The ERROR range may take the priority lane; each range stays in order
+        std::stable_partition(lines.begin(), lines.end(), [&](const std::string& line) {
+            return std::find(std::begin(literals), std::end(literals), line) == std::end(literals);
+        });
+        EXPECT_EQ(lines, expected) << "Engine " << static_cast<int>(variant.engine) << ", async " << variant.async;
+    }
+}
+
+// Test 22: Manual pump writes nothing until poll() and signals through its eventfd
+TEST_F(LoggerTest, ManualPump) {
+    auto countLines = [](const std::string& path) {
+        std::ifstream file(path);
+        size_t count = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            ++count;
+        }
+        return count;
+    };
+    auto readable = [](int fd) {
+        pollfd pfd{fd, POLLIN, 0};
+        return ::poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+    };
+    
+    Logger::Config config;
+    config.logFilePath = "test_logs/pump.log";
+    config.consoleOutput = false;
+    config.asyncLogging = true;
+    config.manualPump = true; // THREAD_POOL engine: runs on LANES
+    config.queueSize = 64;    // Far smaller than the burst below
+    config.pattern = "%v";
+    {
+        Logger logger(config);
+        int fd = logger.eventFd();
+        ASSERT_GE(fd, 0);
+        EXPECT_FALSE(readable(fd));
+        EXPECT_EQ(logger.poll(), 0u);
+        
+        for (int i = 0; i < 10; ++i) {
+            logger.info("queued " + std::to_string(i));
+        }
+        EXPECT_TRUE(readable(fd));
+        EXPECT_EQ(countLines(config.logFilePath), 0u) << "No worker may write";
+        
+        EXPECT_EQ(logger.poll(4), 4u);
+        EXPECT_TRUE(readable(fd)) << "Entries left behind keep the descriptor readable";
+        EXPECT_EQ(logger.poll(), 6u);
+        EXPECT_FALSE(readable(fd));
+        logger.getLogger()->flush();
+        EXPECT_EQ(countLines(config.logFilePath), 10u);
+        
+        // A full queue makes the producer pump instead of waiting forever
+        for (int i = 0; i < 1000; ++i) {
+            logger.info("burst " + std::to_string(i));
+        }
+        logger.flush();
+        EXPECT_EQ(countLines(config.logFilePath), 1010u);
+        EXPECT_FALSE(readable(fd));
+        
+        // Other threads produce, the owning loop pumps
+        std::thread producer([&logger]() {
+            for (int i = 0; i < 500; ++i) {
+                logger.warning("remote " + std::to_string(i));
+            }
+        });
+        producer.join();
+        while (logger.poll() > 0) {
+        }
+        logger.error("left for the destructor");
+    }
+    EXPECT_EQ(countLines(config.logFilePath), 1511u);
+    
+    // Without manual mode there is nothing to pump
+    config.manualPump = false;
+    config.asyncEngine = Logger::AsyncEngine::LANES;
+    Logger automatic(config);
+    EXPECT_EQ(automatic.eventFd(), -1);
+    EXPECT_EQ(automatic.poll(), 0u);
+}
+
+// Test 23: io_uring file backend rotates like the stdio sink and loses nothing
+TEST_F(LoggerTest, IoUringFileBackend) {
+    auto readLines = [](const std::string& path) {
+        std::ifstream file(path);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    };
+    
+    for (bool async : {false, true}) {
+        std::filesystem::remove_all("test_logs");
+        Logger::Config config;
+        config.logFilePath = "test_logs/uring.log";
+        config.consoleOutput = false;
+        config.asyncLogging = async;
+        config.asyncEngine = Logger::AsyncEngine::LANES;
+        config.fileBackend = Logger::FileBackend::IO_URING;
+        config.maxFileSize = 64 * 1024;
+        config.maxFiles = 50;
+        config.pattern = "%v";
+        
+        std::vector<std::string> expected;
+        {
+            Logger logger(config);
+            for (int i = 0; i < 20000; ++i) {
+                expected.push_back("uring line " + std::to_string(i) + " " + std::string(i % 300, 'u'));
+                logger.info(expected.back());
+            }
+            logger.flush();
+            // flush() hands every submitted buffer to the kernel
+            EXPECT_FALSE(readLines(config.logFilePath).empty());
+        }
+        
+        // Oldest rotated file first; each stays within maxFileSize
+        std::vector<std::string> lines;
+        size_t files = 0;
+        for (int i = config.maxFiles; i >= 0; --i) {
+            std::string path = i == 0 ? config.logFilePath : "test_logs/uring." + std::to_string(i) + ".log";
+            if (!std::filesystem::exists(path)) {
+                continue;
+            }
+            ++files;
+            EXPECT_LE(std::filesystem::file_size(path), config.maxFileSize) << path;
+            auto part = readLines(path);
+            lines.insert(lines.end(), part.begin(), part.end());
+        }
+        EXPECT_GT(files, 10u);
+        EXPECT_EQ(lines, expected) << "async " << async;
+    }
+}
+
+// Test 24: Memory-mapped backend leaves files at their written length, even after a crash
+TEST_F(LoggerTest, MmapFileBackend) {
+    auto readFile = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    auto countLines = [](const std::string& text, const std::string& prefix) {
+        size_t count = 0;
+        for (size_t pos = text.find(prefix); pos != std::string::npos; pos = text.find(prefix, pos + 1)) {
+            ++count;
+        }
+        return count;
+    };
+    
+    Logger::Config config;
+    config.logFilePath = "test_logs/mapped.log";
+    config.consoleOutput = false;
+    config.fileBackend = Logger::FileBackend::MMAP;
+    config.maxFileSize = 256 * 1024;
+    config.maxFiles = 20;
+    config.pattern = "%v";
+    
+    // flush() keeps the preallocated tail; rotation and close trim it
+    {
+        Logger logger(config);
+        for (int i = 0; i < 10000; ++i) {
+            logger.info("mapped line " + std::to_string(i) + " " + std::string(i % 90, 'm'));
+        }
+        logger.flush();
+        std::string current = readFile(config.logFilePath);
+        std::string written = current.substr(0, current.find('\0'));
+        std::string last = "mapped line 9999 " + std::string(9999 % 90, 'm') + "\n";
+        ASSERT_GE(written.size(), last.size());
+        EXPECT_EQ(written.substr(written.size() - last.size()), last) << "Flushed records precede the padding";
+    }
+    std::string all;
+    for (int i = config.maxFiles; i >= 0; --i) {
+        std::string path = i == 0 ? config.logFilePath : "test_logs/mapped." + std::to_string(i) + ".log";
+        if (std::filesystem::exists(path)) {
+            EXPECT_LE(std::filesystem::file_size(path), config.maxFileSize);
+            all += readFile(path);
+        }
+    }
+    EXPECT_EQ(all.find('\0'), std::string::npos);
+    EXPECT_EQ(countLines(all, "mapped line "), 10000u);
+    EXPECT_EQ(all.substr(0, 15), "mapped line 0 \n");
+    
+    // A process dying between flushes leaves padding that the next writer strips
+    config.maxFileSize = 16 * 1024 * 1024;
+    std::string path = "test_logs/mapped_exit.log";
+    config.logFilePath = path;
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        Logger logger(config);
+        for (int i = 0; i < 100; ++i) {
+            logger.info("before exit " + std::to_string(i));
+        }
+        _exit(0); // No destructor, no flush
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    std::string padded = readFile(path);
+    EXPECT_EQ(countLines(padded, "before exit "), 100u) << "Copied bytes survive the process";
+    EXPECT_GT(padded.size(), padded.find('\0')) << "Preallocated tail is still there";
+    {
+        Logger logger(config);
+        logger.info("after restart");
+    }
+    std::string recovered = readFile(path);
+    EXPECT_EQ(recovered.find('\0'), std::string::npos);
+    EXPECT_EQ(countLines(recovered, "before exit "), 100u);
+    EXPECT_EQ(recovered.substr(recovered.size() - 14), "after restart\n");
+    
+    // The crash handler trims before appending what was still queued
+    path = "test_logs/mapped_crash.log";
+    config.logFilePath = path;
+    config.asyncLogging = true;
+    config.asyncEngine = Logger::AsyncEngine::LANES;
+    config.crashHandler = true;
+    config.queueSize = 4096;
+    pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        struct rlimit noCore = {0, 0};
+        setrlimit(RLIMIT_CORE, &noCore);
+        Logger logger(config);
+        for (int i = 0; i < 2000; ++i) {
+            logger.info("crash record " + std::to_string(i));
+        }
+        raise(SIGABRT);
+        _exit(0);
+    }
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFSIGNALED(status));
+    std::string crashed = readFile(path);
+    EXPECT_EQ(crashed.find('\0'), std::string::npos) << "Drained records must follow the written bytes";
+    EXPECT_EQ(countLines(crashed, "crash record "), 2000u);
+}
+
+// Test 25: Page-cache bypassing backends write exact, unpadded files across flushes and reopens
+TEST_F(LoggerTest, UncachedFileBackends) {
+    auto readFile = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    
+    for (Logger::FileBackend backend : {Logger::FileBackend::DIRECT, Logger::FileBackend::DONTNEED}) {
+        std::filesystem::remove_all("test_logs");
+        std::filesystem::create_directories("test_logs");
+        Logger::Config config;
+        config.logFilePath = "test_logs/uncached.log";
+        config.consoleOutput = false;
+        config.asyncLogging = true;
+        config.asyncEngine = Logger::AsyncEngine::LANES;
+        config.fileBackend = backend;
+        config.maxFileSize = 3 * 1024 * 1024; // Rotates in the middle of a buffer
+        config.maxFiles = 10;
+        config.pattern = "%v";
+        
+        std::string expected;
+        for (int round = 0; round < 2; ++round) {
+            // The second round appends to a file whose last block is partial
+            Logger logger(config);
+            for (int i = 0; i < 40000; ++i) {
+                std::string line = "round " + std::to_string(round) + " line " + std::to_string(i) + " " +
+                                   std::string(i % 150, 'd');
+                logger.info(line);
+                expected += line + "\n";
+                if (i == 20000) {
+                    logger.flush();
+                    std::string current = readFile(config.logFilePath);
+                    EXPECT_EQ(current.find('\0'), std::string::npos) << "flush() must not pad";
+                    EXPECT_EQ(current.back(), '\n');
+                }
+            }
+        }
+        
+        std::string all;
+        for (int i = config.maxFiles; i >= 0; --i) {
+            std::string path = i == 0 ? config.logFilePath : "test_logs/uncached." + std::to_string(i) + ".log";
+            if (std::filesystem::exists(path)) {
+                all += readFile(path);
+            }
+        }
+        EXPECT_TRUE(std::filesystem::exists("test_logs/uncached.2.log"));
+        EXPECT_EQ(all.size(), expected.size()) << "Backend " << static_cast<int>(backend);
+        EXPECT_TRUE(all == expected) << "Backend " << static_cast<int>(backend);
+    }
+}
+
+// Test 26: Asynchronous rotation keeps every line in order and finishes interrupted rotations
+TEST_F(LoggerTest, AsyncRotation) {
+    auto readFile = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    
+    for (Logger::FileBackend backend : {Logger::FileBackend::STDIO, Logger::FileBackend::MMAP,
+                                        Logger::FileBackend::DIRECT}) {
+        std::filesystem::remove_all("test_logs");
+        std::filesystem::create_directories("test_logs");
+        Logger::Config config;
+        config.logFilePath = "test_logs/rotating.log";
+        config.consoleOutput = false;
+        config.asyncLogging = false; // Rotations run on this thread, back to back
+        config.fileBackend = backend;
+        config.asyncRotation = true;
+        config.maxFileSize = 64 * 1024;
+        config.maxFiles = 50;
+        config.pattern = "%v";
+        
+        std::string expected;
+        {
+            Logger logger(config);
+            for (int i = 0; i < 20000; ++i) {
+                std::string line = "line " + std::to_string(i) + " " + std::string(i % 120, 'r');
+                logger.info(line);
+                expected += line + "\n";
+            }
+        }
+        
+        std::string all;
+        for (int i = config.maxFiles; i >= 0; --i) {
+            std::string path = i == 0 ? config.logFilePath : "test_logs/rotating." + std::to_string(i) + ".log";
+            if (std::filesystem::exists(path)) {
+                std::string content = readFile(path);
+                EXPECT_LE(content.size(), config.maxFileSize) << path;
+                all += content;
+            }
+        }
+        EXPECT_TRUE(std::filesystem::exists("test_logs/rotating.20.log"));
+        EXPECT_FALSE(std::filesystem::exists("test_logs/.rotating.log.next")) << "Hidden file left behind";
+        EXPECT_TRUE(all == expected) << "Backend " << static_cast<int>(backend);
+    }
+    
+    // A process that died between the swap and the renames left the newest lines in the hidden file
+    std::filesystem::remove_all("test_logs");
+    std::filesystem::create_directories("test_logs");
+    std::ofstream("test_logs/rotating.log") << "old\n";
+    std::ofstream("test_logs/.rotating.log.next") << "pending\n";
+    {
+        Logger::Config config;
+        config.logFilePath = "test_logs/rotating.log";
+        config.consoleOutput = false;
+        config.asyncRotation = true;
+        config.pattern = "%v";
+        Logger logger(config);
+        logger.info("new");
+    }
+    EXPECT_EQ(readFile("test_logs/rotating.1.log"), "old\n");
+    EXPECT_EQ(readFile("test_logs/rotating.log"), "pending\nnew\n");
+    EXPECT_FALSE(std::filesystem::exists("test_logs/.rotating.log.next"));
+}
+
+// Test 27: Sequential rotation names keep the newest maxFiles files and continue numbering on restart
+TEST_F(LoggerTest, SequentialRotationNaming) {
+    auto readFile = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    auto rotatedNumbers = []() {
+        std::vector<int> numbers;
+        for (const auto& entry : std::filesystem::directory_iterator("test_logs")) {
+            std::string name = entry.path().filename().string();
+            if (name.rfind("sequential.", 0) == 0 && name != "sequential.log") {
+                numbers.push_back(std::stoi(name.substr(11)));
+            }
+        }
+        std::sort(numbers.begin(), numbers.end());
+        return numbers;
+    };
+    
+    for (bool asyncRotation : {false, true}) {
+        std::filesystem::remove_all("test_logs");
+        std::filesystem::create_directories("test_logs");
+        Logger::Config config;
+        config.logFilePath = "test_logs/sequential.log";
+        config.consoleOutput = false;
+        config.rotationNaming = Logger::RotationNaming::SEQUENTIAL;
+        config.asyncRotation = asyncRotation;
+        config.maxFileSize = 16 * 1024;
+        config.maxFiles = 5;
+        config.pattern = "%v";
+        
+        std::vector<std::string> lines;
+        int lastNumber = 0;
+        for (int run = 0; run < 2; ++run) {
+            {
+                Logger logger(config);
+                for (int i = 0; i < 10000; ++i) {
+                    lines.push_back("run " + std::to_string(run) + " line " + std::to_string(i));
+                    logger.info(lines.back());
+                }
+            }
+            std::vector<int> numbers = rotatedNumbers();
+            ASSERT_EQ(numbers.size(), 5u);
+            EXPECT_EQ(numbers.back() - numbers.front(), 4) << "Kept files must be the newest, contiguous";
+            EXPECT_GT(numbers.front(), lastNumber) << "Numbering must continue across restarts";
+            lastNumber = numbers.back();
+            
+            // Oldest kept file first, then the active one: a suffix of everything logged, in order
+            std::string kept;
+            for (int number : numbers) {
+                kept += readFile("test_logs/sequential." + std::to_string(number) + ".log");
+            }
+            kept += readFile(config.logFilePath);
+            std::string expected;
+            for (auto line = lines.rbegin(); line != lines.rend() && expected.size() < kept.size(); ++line) {
+                expected.insert(0, *line + "\n");
+            }
+            EXPECT_TRUE(kept == expected) << "Async rotation " << asyncRotation << ", run " << run;
+        }
+    }
+}
+
+// Test 28: Rotated files are gzipped in the background, retained by count, and recovered on restart
+TEST_F(LoggerTest, CompressRotatedFiles) {
+#ifndef FRESHLOGGER_WITH_ZLIB
+    GTEST_SKIP() << "Built without FRESHLOGGER_WITH_ZLIB";
+#else
+    auto readFile = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    auto readGzip = [](const std::string& path) {
+        std::string content;
+        gzFile file = gzopen(path.c_str(), "rb");
+        char buffer[4096];
+        int n = 0;
+        while (file != nullptr && (n = gzread(file, buffer, sizeof(buffer))) > 0) {
+            content.append(buffer, static_cast<size_t>(n));
+        }
+        if (file != nullptr) {
+            gzclose(file);
+        }
+        return content;
+    };
+    auto waitFor = [](const std::function<bool()>& done) {
+        for (int i = 0; i < 1000 && !done(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return done();
+    };
+    auto rotated = [](const std::string& suffix) {
+        std::vector<int> numbers;
+        for (const auto& entry : std::filesystem::directory_iterator("test_logs")) {
+            std::string name = entry.path().filename().string();
+            std::string tail = ".log" + suffix;
+            if (name.rfind("zipped.", 0) == 0 && name != "zipped.log" && name.size() > tail.size() &&
+                name.compare(name.size() - tail.size(), tail.size(), tail) == 0 &&
+                name.find_first_not_of("0123456789", 7) == name.size() - tail.size()) {
+                numbers.push_back(std::stoi(name.substr(7)));
+            }
+        }
+        std::sort(numbers.begin(), numbers.end());
+        return numbers;
+    };
+    
+    Logger::Config config;
+    config.logFilePath = "test_logs/zipped.log";
+    config.consoleOutput = false;
+    config.compressRotated = true;
+    config.maxFileSize = 32 * 1024;
+    config.maxFiles = 4;
+    config.pattern = "%v";
+    
+    // A file left uncompressed by an earlier run, and an abandoned partial compression
+    std::ofstream("test_logs/zipped.7.log") << "leftover\n";
+    std::ofstream("test_logs/zipped.6.log.gz.part") << "partial";
+    {
+        Logger logger(config);
+        EXPECT_TRUE(waitFor([&] { return std::filesystem::exists("test_logs/zipped.7.log.gz"); }));
+    }
+    EXPECT_EQ(readGzip("test_logs/zipped.7.log.gz"), "leftover\n");
+    EXPECT_FALSE(std::filesystem::exists("test_logs/zipped.7.log"));
+    EXPECT_FALSE(std::filesystem::exists("test_logs/zipped.6.log.gz.part"));
+    
+    std::vector<std::string> lines;
+    for (bool asyncRotation : {false, true}) {
+        config.asyncRotation = asyncRotation;
+        Logger logger(config);
+        for (int i = 0; i < 20000; ++i) {
+            lines.push_back("line " + std::to_string(i) + (asyncRotation ? " async" : " inline"));
+            logger.info(lines.back());
+        }
+        EXPECT_TRUE(waitFor([&] { return rotated("").empty(); })) << "Rotated files should all be compressed";
+    }
+    
+    std::vector<int> numbers = rotated(".gz");
+    ASSERT_EQ(numbers.size(), 4u) << "Retention counts compressed files";
+    EXPECT_GT(numbers.front(), 7) << "Numbering continues after the leftover file";
+    EXPECT_EQ(numbers.back() - numbers.front(), 3);
+    std::string kept;
+    for (int number : numbers) {
+        kept += readGzip("test_logs/zipped." + std::to_string(number) + ".log.gz");
+    }
+    kept += readFile(config.logFilePath);
+    std::string expected;
+    for (auto line = lines.rbegin(); line != lines.rend() && expected.size() < kept.size(); ++line) {
+        expected.insert(0, *line + "\n");
+    }
+    EXPECT_TRUE(kept == expected);
+    EXPECT_TRUE(rotated(".gz.part").empty());
+#endif
+}
+
+// Test 29: The GZIP backend writes independent, length-tagged gzip members and keeps crash drains out of them
+TEST_F(LoggerTest, GzipFileBackend) {
+#ifndef FRESHLOGGER_WITH_ZLIB
+    GTEST_SKIP() << "Built without FRESHLOGGER_WITH_ZLIB";
+#else
+    auto readFile = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    // Inflates one member on its own, as a reader seeking to a frame would
+    auto inflateMember = [](const std::string& member) {
+        z_stream stream{};
+        inflateInit2(&stream, 15 + 16);
+        std::string text(4 * 1024 * 1024, '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(member.data()));
+        stream.avail_in = static_cast<uInt>(member.size());
+        stream.next_out = reinterpret_cast<Bytef*>(text.data());
+        stream.avail_out = static_cast<uInt>(text.size());
+        int rc = inflate(&stream, Z_FINISH);
+        text.resize(rc == Z_STREAM_END && stream.avail_in == 0 ? stream.total_out : 0);
+        inflateEnd(&stream);
+        return text;
+    };
+    // Follows the 'FL' length subfield from member to member
+    auto inflateFrames = [&](const std::string& file, size_t* frames) {
+        std::string text;
+        size_t offset = 0;
+        *frames = 0;
+        while (offset + 20 <= file.size()) {
+            EXPECT_EQ(file.compare(offset + 12, 2, "FL"), 0) << "Member at " << offset;
+            size_t length = 0;
+            for (size_t i = 0; i < 4; ++i) {
+                length |= static_cast<size_t>(static_cast<unsigned char>(file[offset + 16 + i])) << (8 * i);
+            }
+            if (length == 0 || offset + length > file.size()) {
+                break;
+            }
+            text += inflateMember(file.substr(offset, length));
+            offset += length;
+            ++*frames;
+        }
+        EXPECT_EQ(offset, file.size()) << "Members must tile the file";
+        return text;
+    };
+    
+    Logger::Config config;
+    config.logFilePath = "test_logs/stream.log.gz";
+    config.consoleOutput = false;
+    config.asyncLogging = true;
+    config.asyncEngine = Logger::AsyncEngine::LANES;
+    config.fileBackend = Logger::FileBackend::GZIP;
+    config.maxFileSize = 200 * 1024;
+    config.maxFiles = 50;
+    config.pattern = "%v";
+    
+    std::string expected;
+    size_t frames = 0;
+    {
+        Logger logger(config);
+        for (int i = 0; i < 100; ++i) {
+            std::string line = "flushed line " + std::to_string(i);
+            logger.info(line);
+            expected += line + "\n";
+        }
+        logger.flush();
+        // A flush closes the frame: what is on disk decodes on its own
+        EXPECT_EQ(inflateFrames(readFile(config.logFilePath), &frames), expected);
+        EXPECT_EQ(frames, 1u);
+        
+        for (int i = 0; i < 200000; ++i) {
+            std::string line = "frame line " + std::to_string(i) + " status=ok user=" + std::to_string(i % 97);
+            logger.info(line);
+            expected += line + "\n";
+        }
+    }
+    
+    std::string all;
+    size_t total = 0;
+    for (int i = config.maxFiles; i >= 0; --i) {
+        std::string path = i == 0 ? config.logFilePath : "test_logs/stream.log." + std::to_string(i) + ".gz";
+        if (std::filesystem::exists(path)) {
+            std::string file = readFile(path);
+            EXPECT_LT(file.size(), 2 * config.maxFileSize) << path;
+            all += inflateFrames(file, &frames);
+            total += frames;
+        }
+    }
+    EXPECT_TRUE(std::filesystem::exists("test_logs/stream.log.1.gz")) << "Rotation by compressed size";
+    EXPECT_GT(total, 10u);
+    EXPECT_TRUE(all == expected);
+    
+    // Standard readers see one multi-member gzip stream
+    gzFile file = gzopen(config.logFilePath.c_str(), "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[64] = {};
+    EXPECT_GT(gzread(file, buffer, sizeof(buffer) - 1), 0);
+    gzclose(file);
+    
+    // The crash drain goes to a plain sidecar so the gzip stream stays intact
+    config.logFilePath = "test_logs/stream_crash.log.gz";
+    config.crashHandler = true;
+    config.queueSize = 4096;
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        struct rlimit noCore = {0, 0};
+        setrlimit(RLIMIT_CORE, &noCore);
+        Logger logger(config);
+        for (int i = 0; i < 2000; ++i) {
+            logger.info("crash record " + std::to_string(i));
+        }
+        raise(SIGABRT);
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFSIGNALED(status));
+    std::string written = inflateFrames(readFile(config.logFilePath), &frames);
+    std::string drained = readFile(config.logFilePath + ".crash");
+    size_t found = 0;
+    for (const std::string* text : {&written, &drained}) {
+        for (size_t pos = text->find("crash record "); pos != std::string::npos;
+             pos = text->find("crash record ", pos + 1)) {
+            ++found;
+        }
+    }
+    EXPECT_EQ(found, 2000u);
+#endif
+}
+
+// Test 30: Period boundaries rotate files from earlier periods, and maxTotalSize caps rotated bytes
+TEST_F(LoggerTest, TimeRotationAndTotalSizeRetention) {
+    auto readFile = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    auto writeAged = [](const std::string& path, const std::string& content, std::chrono::hours age) {
+        std::ofstream(path) << content;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() - age);
+    };
+    
+    Logger::Config config;
+    config.consoleOutput = false;
+    config.pattern = "%v";
+    
+    // A file last written two days ago belongs to an earlier day
+    config.logFilePath = "test_logs/daily.log";
+    config.rotationInterval = Logger::RotationInterval::DAILY;
+    writeAged(config.logFilePath, "two days ago\n", std::chrono::hours(48));
+    {
+        Logger logger(config);
+        logger.info("today");
+    }
+    EXPECT_EQ(readFile("test_logs/daily.1.log"), "two days ago\n");
+    EXPECT_EQ(readFile(config.logFilePath), "today\n");
+    {
+        Logger logger(config);
+        logger.info("still today");
+    }
+    EXPECT_EQ(readFile(config.logFilePath), "today\nstill today\n") << "Same period: no rotation";
+    EXPECT_FALSE(std::filesystem::exists("test_logs/daily.2.log"));
+    
+    config.logFilePath = "test_logs/hourly.log";
+    config.rotationInterval = Logger::RotationInterval::HOURLY;
+    config.rotationNaming = Logger::RotationNaming::SEQUENTIAL;
+    config.asyncRotation = true;
+    writeAged(config.logFilePath, "two hours ago\n", std::chrono::hours(2));
+    {
+        Logger logger(config);
+        logger.info("this hour");
+    }
+    EXPECT_EQ(readFile("test_logs/hourly.1.log"), "two hours ago\n");
+    EXPECT_EQ(readFile(config.logFilePath), "this hour\n");
+    
+    // Total-bytes retention, with a file count that would keep far more
+    for (Logger::RotationNaming naming : {Logger::RotationNaming::CASCADE, Logger::RotationNaming::SEQUENTIAL}) {
+        std::filesystem::remove_all("test_logs");
+        std::filesystem::create_directories("test_logs");
+        Logger::Config capped;
+        capped.logFilePath = "test_logs/capped.log";
+        capped.consoleOutput = false;
+        capped.rotationNaming = naming;
+        capped.maxFileSize = 10 * 1024;
+        capped.maxFiles = 100;
+        capped.maxTotalSize = 50 * 1024;
+        {
+            Logger logger(capped);
+            for (int i = 0; i < 10000; ++i) {
+                logger.info("capped line " + std::to_string(i));
+            }
+        }
+        uintmax_t rotated = 0;
+        int files = 0;
+        for (const auto& entry : std::filesystem::directory_iterator("test_logs")) {
+            if (entry.path().filename() != "capped.log") {
+                rotated += entry.file_size();
+                ++files;
+            }
+        }
+        EXPECT_LE(rotated, capped.maxTotalSize) << "Naming " << static_cast<int>(naming);
+        EXPECT_GE(rotated, capped.maxTotalSize - capped.maxFileSize) << "Naming " << static_cast<int>(naming);
+        EXPECT_GE(files, 4);
+    }
+}
+
+// Test 31: Durability policies and group commit keep every record and make ERRORs visible
+TEST_F(LoggerTest, DurabilityAndGroupCommit) {
+    auto readFile = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    
+    for (Logger::Durability durability : {Logger::Durability::NONE, Logger::Durability::FLUSH,
+                                          Logger::Durability::FDATASYNC}) {
+        for (int window : {0, 20}) {
+            std::string tag = std::to_string(static_cast<int>(durability)) + "_" + std::to_string(window);
+            Logger::Config config;
+            config.logFilePath = "test_logs/durability_" + tag + ".log";
+            config.consoleOutput = false;
+            config.pattern = "%v";
+            config.asyncLogging = true;
+            config.asyncEngine = Logger::AsyncEngine::LANES;
+            config.durability = durability;
+            config.groupCommitWindow = std::chrono::milliseconds(window);
+            {
+                Logger logger(config);
+                for (int i = 0; i < 1000; ++i) {
+                    if (i % 10 == 0) {
+                        logger.error("line " + std::to_string(i));
+                    } else {
+                        logger.info("line " + std::to_string(i));
+                    }
+                }
+            }
+            std::string content = readFile(config.logFilePath);
+            EXPECT_EQ(std::count(content.begin(), content.end(), '\n'), 1000) << tag;
+        }
+    }
+    
+    Logger::Config config;
+    config.consoleOutput = false;
+    config.pattern = "%v";
+    config.rotationNaming = Logger::RotationNaming::SEQUENTIAL;  // Buffered writer on every policy
+    
+    // NONE leaves an ERROR in the write buffer until something flushes it
+    config.logFilePath = "test_logs/none.log";
+    config.durability = Logger::Durability::NONE;
+    {
+        Logger logger(config);
+        logger.error("buffered error");
+        EXPECT_EQ(readFile(config.logFilePath), "");
+        logger.flush();
+        EXPECT_EQ(readFile(config.logFilePath), "buffered error\n");
+    }
+    
+    // FLUSH without a window: the ERROR is in the file when error() returns
+    config.logFilePath = "test_logs/flush.log";
+    config.durability = Logger::Durability::FLUSH;
+    {
+        Logger logger(config);
+        logger.info("buffered info");
+        logger.error("flushed error");
+        EXPECT_EQ(readFile(config.logFilePath), "buffered info\nflushed error\n");
+    }
+    
+    // The window only groups an engine's backlog: a synchronous logger flushes each ERROR
+    config.logFilePath = "test_logs/group.log";
+    config.durability = Logger::Durability::FDATASYNC;
+    config.groupCommitWindow = std::chrono::milliseconds(10000);
+    {
+        Logger logger(config);
+        logger.error("committed error");
+        EXPECT_EQ(readFile(config.logFilePath), "committed error\n");
+    }
+    
+    // A worker out of records commits before it sleeps: killing the process
+    // inside the window loses nothing that was logged before the ERROR
+    for (bool async : {false, true}) {
+        config.logFilePath = std::string("test_logs/killed_") + (async ? "async" : "sync") + ".log";
+        config.asyncLogging = async;
+        config.asyncEngine = Logger::AsyncEngine::LANES;
+        pid_t pid = fork();
+        ASSERT_NE(pid, -1);
+        if (pid == 0) {
+            Logger logger(config);
+            logger.info("before the error");
+            logger.error("durable error");
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            raise(SIGKILL);
+            _exit(0);
+        }
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        EXPECT_TRUE(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+        // The priority lane may write the ERROR first
+        std::string content = readFile(config.logFilePath);
+        EXPECT_EQ(content.size(), std::string("before the error\ndurable error\n").size()) << content;
+        EXPECT_NE(content.find("before the error\n"), std::string::npos) << (async ? "LANES" : "sync");
+        EXPECT_NE(content.find("durable error\n"), std::string::npos) << (async ? "LANES" : "sync");
+    }
+}
+
+// Test 32: Buffered console mode batches colorless stdout output when stdout is not a terminal
+TEST_F(LoggerTest, BufferedConsoleOutput) {
+    int pipeFds[2];
+    ASSERT_EQ(pipe(pipeFds), 0);
+    fcntl(pipeFds[0], F_SETFL, O_NONBLOCK);
+    std::cout.flush();
+    fflush(stdout);
+    int savedStdout = dup(STDOUT_FILENO);
+    dup2(pipeFds[1], STDOUT_FILENO);
+    auto drain = [&]() {
+        std::string text;
+        char chunk[4096];
+        ssize_t n;
+        while ((n = read(pipeFds[0], chunk, sizeof(chunk))) > 0) {
+            text.append(chunk, static_cast<size_t>(n));
+        }
+        return text;
+    };
+    
+    Logger::Config config;
+    config.pattern = "%^%v%$";  // Color range markers
+    config.consoleMode = Logger::ConsoleMode::AUTO;
+    std::string beforeFlush;
+    std::string afterFlush;
+    {
+        Logger logger(config);
+        logger.info("first");
+        logger.info("second");
+        beforeFlush = drain();
+        logger.flush();
+        afterFlush = drain();
+        logger.warning("third");
+    }
+    std::string atShutdown = drain();
+    
+    // A short interval writes a quiet logger's lines without a flush
+    config.consoleMode = Logger::ConsoleMode::BUFFERED;
+    config.flushInterval = 1;
+    std::string timed;
+    {
+        Logger logger(config);
+        logger.info("timed");
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (timed.empty() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            timed = drain();
+        }
+    }
+    
+    dup2(savedStdout, STDOUT_FILENO);
+    close(savedStdout);
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+    
+    EXPECT_EQ(beforeFlush, "") << "Records wait in the buffer";
+    EXPECT_EQ(afterFlush, "first\nsecond\n") << "No escape codes on a pipe";
+    EXPECT_EQ(atShutdown, "third\n");
+    EXPECT_EQ(timed, "timed\n");
+}
+
+// Test 33: The priority lane is written before a queued backlog, and each lane stays in order
+TEST_F(LoggerTest, PriorityLaneDrainsFirst) {
+    const std::pair<const char*, Logger::AsyncEngine> engines[] = {
+        {"lanes", Logger::AsyncEngine::LANES},
+        {"lock_free", Logger::AsyncEngine::LOCK_FREE},
+        {"byte_ring", Logger::AsyncEngine::BYTE_RING},
+    };
+    for (const auto& engine : engines) {
+        Logger::Config config;
+        config.logFilePath = std::string("test_logs/priority_") + engine.first + ".log";
+        config.consoleOutput = false;
+        config.asyncLogging = true;
+        config.asyncEngine = engine.second;
+        config.manualPump = true;  // The backlog stays queued until poll()
+        config.queueSize = 4096;
+        config.pattern = "%v";
+        
+        const int backlog = 1000;
+        Logger logger(config);
+        for (int i = 0; i < backlog; ++i) {
+            logger.info("info " + std::to_string(i));
+        }
+        logger.error("error 0");
+        logger.fatal("fatal 1");
+        
+        // The first two entries written are the priority records, flushed at once
+        EXPECT_EQ(logger.poll(2), 2u) << engine.first;
+        EXPECT_EQ(readLogFile(config.logFilePath), "error 0\nfatal 1\n") << engine.first;
+        
+        while (logger.poll() > 0) {
+        }
+        logger.flush();
+        std::istringstream lines(readLogFile(config.logFilePath));
+        std::string line;
+        std::getline(lines, line);
+        std::getline(lines, line);
+        int next = 0;
+        while (std::getline(lines, line)) {
+            EXPECT_EQ(line, "info " + std::to_string(next)) << engine.first;
+            ++next;
+        }
+        EXPECT_EQ(next, backlog) << engine.first;
+    }
+}
+
+// Test 34: shutdown() stops draining a backed-up queue at its deadline and reports what it dropped
+TEST_F(LoggerTest, ShutdownDeadline) {
+    // A FIFO read slowly stands in for a slow disk
+    const std::string path = "test_logs/slow.log";
+    ASSERT_EQ(mkfifo(path.c_str(), 0644), 0);
+    std::string received;
+    std::thread reader([&path, &received]() {
+        int fd = open(path.c_str(), O_RDONLY);
+        char chunk[1024];
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+            received.append(chunk, static_cast<size_t>(n));
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        close(fd);
+    });
+    
+    Logger::Config config;
+    config.logFilePath = path;
+    config.consoleOutput = false;
+    config.asyncLogging = true;
+    config.asyncEngine = Logger::AsyncEngine::LANES;
+    config.queueSize = 32768;  // Holds the whole burst, so producers never wait
+    config.pattern = "%v";
+    
+    const int records = 20000;
+    const auto deadline = std::chrono::milliseconds(100);
+    size_t abandoned = 0;
+    std::chrono::steady_clock::duration elapsed{};
+    {
+        Logger logger(config);
+        for (int i = 0; i < records; ++i) {
+            logger.info("record " + std::to_string(i));
+        }
+        auto start = std::chrono::steady_clock::now();
+        abandoned = logger.shutdown(deadline);
+        elapsed = std::chrono::steady_clock::now() - start;
+        logger.info("after shutdown");
+    }
+    reader.join();
+    
+    EXPECT_GT(abandoned, 0u) << "The reader cannot take 20000 records in 100 ms";
+    EXPECT_LT(elapsed, deadline + std::chrono::seconds(1)) << "shutdown() must return soon after its deadline";
+    std::istringstream lines(received);
+    std::string line;
+    size_t written = 0;
+    int next = 0;
+    while (std::getline(lines, line)) {
+        if (line.rfind("record ", 0) == 0) {
+            EXPECT_EQ(line, "record " + std::to_string(next));
+            ++next;
+            ++written;
+        }
+    }
+    EXPECT_EQ(written + abandoned, static_cast<size_t>(records)) << "Every record is written or counted";
+    EXPECT_NE(received.find("Shutdown deadline reached, " + std::to_string(abandoned) + " queued records abandoned"),
+              std::string::npos);
+    EXPECT_EQ(received.find("after shutdown"), std::string::npos);
+    
+    // spdlog's pool cannot drop records: the call is bounded and the pool writes the rest later
+    std::filesystem::remove(path);
+    ASSERT_EQ(mkfifo(path.c_str(), 0644), 0);
+    received.clear();
+    std::thread poolReader([&path, &received]() {
+        int fd = open(path.c_str(), O_RDONLY);
+        char chunk[1024];
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+            received.append(chunk, static_cast<size_t>(n));
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        close(fd);
+    });
+    config.asyncEngine = Logger::AsyncEngine::THREAD_POOL;
+    {
+        Logger logger(config);
+        for (int i = 0; i < records; ++i) {
+            logger.info("record " + std::to_string(i));
+        }
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_EQ(logger.shutdown(deadline), 0u);
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+    poolReader.join();
+    EXPECT_LT(elapsed, deadline + std::chrono::seconds(1)) << "THREAD_POOL: the wait is bounded too";
+    EXPECT_EQ(std::count(received.begin(), received.end(), '\n'), records) << "THREAD_POOL never drops";
+}
+
+// Test 35: flushAsync() resolves only once every earlier record is in the file
+TEST_F(LoggerTest, FlushAsyncCompletion) {
+    auto countLines = [this](const std::string& path) {
+        std::string content = readLogFile(path);
+        return static_cast<size_t>(std::count(content.begin(), content.end(), '\n'));
+    };
+    const std::pair<const char*, Logger::AsyncEngine> engines[] = {
+        {"thread_pool", Logger::AsyncEngine::THREAD_POOL},
+        {"lanes", Logger::AsyncEngine::LANES},
+        {"lock_free", Logger::AsyncEngine::LOCK_FREE},
+        {"byte_ring", Logger::AsyncEngine::BYTE_RING},
+    };
+    const size_t records = 20000;
+    for (const auto& engine : engines) {
+        Logger::Config config;
+        config.logFilePath = std::string("test_logs/flush_async_") + engine.first + ".log";
+        config.consoleOutput = false;
+        config.asyncLogging = true;
+        config.asyncEngine = engine.second;
+        config.pattern = "%v";
+        
+        Logger logger(config);
+        for (size_t i = 0; i < records; ++i) {
+            logger.info("record " + std::to_string(i));
+        }
+        std::atomic<size_t> seenByCallback{0};
+        auto done = logger.flushAsync([&]() { seenByCallback = countLines(config.logFilePath); });
+        done.wait();
+        EXPECT_EQ(seenByCallback.load(), records) << engine.first << ": callback ran before the flush";
+        EXPECT_EQ(countLines(config.logFilePath), records) << engine.first;
+        
+        logger.info("one more");
+        logger.flushAsync().wait();
+        EXPECT_EQ(countLines(config.logFilePath), records + 1) << engine.first;
+    }
+}
+
+// Test 36: flushInterval writes out buffered file records of an idle logger
+TEST_F(LoggerTest, FlushIntervalTimer) {
+    // Decompresses transparently; plain files are read as they are
+    auto readText = [](const std::string& path) {
+#ifndef FRESHLOGGER_WITH_ZLIB
+        std::ifstream plain(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(plain), std::istreambuf_iterator<char>());
+#else
+        std::string text;
+        gzFile file = gzopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            return text;
+        }
+        char buffer[4096];
+        int n = 0;
+        while ((n = gzread(file, buffer, sizeof(buffer))) > 0) {
+            text.append(buffer, static_cast<size_t>(n));
+        }
+        gzclose(file);
+        return text;
+#endif
+    };
+    
+    std::vector<std::pair<std::string, Logger::FileBackend>> backends = {{"STDIO", Logger::FileBackend::STDIO}};
+#ifdef FRESHLOGGER_WITH_ZLIB
+    backends.emplace_back("GZIP", Logger::FileBackend::GZIP);
+#endif
+    for (const auto& backend : backends) {
+        Logger::Config config;
+        config.logFilePath = "test_logs/interval_" + backend.first + ".log";
+        config.consoleOutput = false;
+        config.fileBackend = backend.second;
+        config.flushInterval = 1;
+        config.pattern = "%v";
+        // Default STDIO is spdlog's sink; sequential naming puts it on FileSink
+        config.rotationNaming = Logger::RotationNaming::SEQUENTIAL;
+        
+        Logger logger(config);
+        for (int i = 0; i < 10; ++i) {
+            logger.info("idle record " + std::to_string(i));
+        }
+        EXPECT_EQ(readText(config.logFilePath), "") << backend.first << ": records are buffered";
+        std::string expected;
+        for (int i = 0; i < 10; ++i) {
+            expected += "idle record " + std::to_string(i) + "\n";
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (readText(config.logFilePath) != expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        EXPECT_EQ(readText(config.logFilePath), expected) << backend.first << ": timer did not flush";
+    }
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
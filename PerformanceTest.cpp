@@ -25,6 +25,17 @@
 #include <iomanip>
 #include <numeric>
 #include <algorithm>
+#include <future>
+#include <cstdint>
+#include <linux/perf_event.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <malloc.h>
+#include <random>
 
 class PerformanceTest : public ::testing::Test {
 protected:
@@ -193,6 +204,49 @@ TEST_F(PerformanceTest, SingleMessageLatency) {
     EXPECT_LT(maxLatency, 10000) << "Max latency should be < 10ms";
 }
 
+TEST_F(PerformanceTest, FlushAsyncVsSyncLatency) {
+    Logger::Config config = perfConfig;
+    config.asyncEngine = Logger::AsyncEngine::LANES;
+    Logger logger(config);
+    
+    const int rounds = 200;
+    const int messagesPerRound = 100;
+    long long syncBlocked = 0;
+    long long asyncBlocked = 0;
+    long long asyncCompleted = 0;
+    std::atomic<int> callbacks{0};
+    
+    for (int round = 0; round < rounds; ++round) {
+        for (int i = 0; i < messagesPerRound; ++i) {
+            logger.info("Sync flush round " + std::to_string(round) + " message " + std::to_string(i));
+        }
+        syncBlocked += measureTime([&]() { logger.flush(); }).count();
+    }
+    
+    for (int round = 0; round < rounds; ++round) {
+        for (int i = 0; i < messagesPerRound; ++i) {
+            logger.info("Async flush round " + std::to_string(round) + " message " + std::to_string(i));
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        std::future<void> done;
+        asyncBlocked += measureTime([&]() {
+            done = logger.flushAsync([&callbacks]() { callbacks++; });
+        }).count();
+        done.wait();
+        asyncCompleted += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    }
+    
+    std::cout << "\n=== FLUSH ASYNC VS SYNC LATENCY ===" << std::endl;
+    std::cout << "Rounds: " << rounds << " x " << messagesPerRound << " messages" << std::endl;
+    std::cout << "flush() caller blocked: " << syncBlocked / rounds << " μs avg" << std::endl;
+    std::cout << "flushAsync() caller blocked: " << asyncBlocked / rounds << " μs avg" << std::endl;
+    std::cout << "flushAsync() completion: " << asyncCompleted / rounds << " μs avg" << std::endl;
+    
+    EXPECT_EQ(callbacks.load(), rounds) << "Every flush callback should run";
+    EXPECT_LT(asyncBlocked, syncBlocked) << "flushAsync() should block the caller less than flush()";
+}
+
 // ==================== MEMORY TESTS ====================
 
 TEST_F(PerformanceTest, MemoryUsageUnderLoad) {
@@ -319,48 +373,96 @@ TEST_F(PerformanceTest, HighLoadStressTest) {
 // ==================== FILE ROTATION PERFORMANCE ====================
 
 TEST_F(PerformanceTest, FileRotationPerformance) {
-    Logger::Config config = perfConfig;
-    config.maxFileSize = 1024 * 10; // 10KB - smaller size for reliable rotation
-    config.maxFiles = 3;
-    
-    Logger logger(config);
-    
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    // First, create some small log files to establish rotation sequence
-    for (int i = 0; i < 100; ++i) {
-        logger.info("Initial log message " + std::to_string(i));
-    }
-    logger.flush();
-    
-    // Now add large messages to trigger rotation
-    for (int i = 0; i < MEDIUM_TEST_SIZE; ++i) {
-        logger.info("File rotation test message " + std::to_string(i) + 
-                   " with additional content to exceed file size limit " +
-                   std::string(500, 'X')); // Smaller message for more reliable rotation
-    }
-    
-    logger.flush();
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    
-    double throughput = calculateThroughput(MEDIUM_TEST_SIZE, duration);
-    
     std::cout << "\n=== FILE ROTATION PERFORMANCE TEST ===" << std::endl;
     std::cout << "Messages: " << MEDIUM_TEST_SIZE << std::endl;
-    std::cout << "Duration: " << duration.count() << " μs" << std::endl;
-    std::cout << "Throughput: " << std::fixed << std::setprecision(2) 
-              << throughput << " msg/sec" << std::endl;
     
-    // Check if log file was created (basic functionality test)
-    bool logFileExists = std::filesystem::exists(config.logFilePath);
-    std::cout << "Log file exists: " << (logFileExists ? "Yes" : "No") << std::endl;
+    const std::pair<const char*, Logger::FileBackend> backends[] = {
+        {"STDIO", Logger::FileBackend::STDIO},
+        {"IO_URING", Logger::FileBackend::IO_URING},
+        {"MMAP", Logger::FileBackend::MMAP},
+    };
+    for (const auto& backend : backends) {
+        Logger::Config config = perfConfig;
+        config.maxFileSize = 1024 * 10; // 10KB - smaller size for reliable rotation
+        config.maxFiles = 3;
+        config.fileBackend = backend.second;
+        config.logFilePath = testDir + "/rotation_" + backend.first + ".log";
+        
+        // Destroyed before the checks: THREAD_POOL's flush() does not wait
+        std::chrono::microseconds duration{};
+        {
+            Logger logger(config);
+            
+            auto start = std::chrono::high_resolution_clock::now();
+            
+            // First, create some small log files to establish rotation sequence
+            for (int i = 0; i < 100; ++i) {
+                logger.info("Initial log message " + std::to_string(i));
+            }
+            logger.flush();
+            
+            // Now add large messages to trigger rotation
+            for (int i = 0; i < MEDIUM_TEST_SIZE; ++i) {
+                logger.info("File rotation test message " + std::to_string(i) + 
+                           " with additional content to exceed file size limit " +
+                           std::string(500, 'X')); // Smaller message for more reliable rotation
+            }
+            
+            logger.flush();
+            
+            auto end = std::chrono::high_resolution_clock::now();
+            duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        }
+        
+        double throughput = calculateThroughput(MEDIUM_TEST_SIZE, duration);
+        
+        std::cout << backend.first << " duration: " << duration.count() << " μs, throughput: " << std::fixed
+                  << std::setprecision(2) << throughput << " msg/sec" << std::endl;
+        
+        // Check if log file was created (basic functionality test)
+        bool logFileExists = std::filesystem::exists(config.logFilePath);
+        
+        // Enterprise-grade expectations (simplified for reliability)
+        EXPECT_GT(throughput, 30000.0) << "File rotation should maintain > 30,000 msg/sec";
+        EXPECT_TRUE(logFileExists) << "Log file should be created";
+        EXPECT_LT(duration.count(), 5000000) << "Should complete in < 5 seconds";
+    }
     
-    // Enterprise-grade expectations (simplified for reliability)
-    EXPECT_GT(throughput, 30000.0) << "File rotation should maintain > 30,000 msg/sec";
-    EXPECT_TRUE(logFileExists) << "Log file should be created";
-    EXPECT_LT(duration.count(), 5000000) << "Should complete in < 5 seconds";
+    // Sustained file writes without rotation, where the write path dominates:
+    // synchronously on the calling thread, and from a LANES worker
+    std::cout << std::setw(12) << "Backend" << std::setw(16) << "sync msg/sec" << std::setw(10) << "MB/s"
+              << std::setw(16) << "LANES msg/sec" << std::setw(10) << "MB/s" << std::endl;
+    const std::string payload(200, 'W');
+    for (const auto& backend : backends) {
+        std::cout << std::setw(12) << backend.first;
+        for (bool async : {false, true}) {
+            Logger::Config config = perfConfig;
+            config.asyncLogging = async;
+            config.asyncEngine = Logger::AsyncEngine::LANES;
+            config.fileBackend = backend.second;
+            config.logFilePath = testDir + "/write_" + backend.first + ".log";
+            config.maxFileSize = 1024 * LoggerConstants::MEGABYTE; // One file, so its size is the total written
+            std::chrono::microseconds duration{};
+            {
+                Logger logger(config);
+                auto start = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < LARGE_TEST_SIZE; ++i) {
+                    logger.info(payload);
+                }
+                logger.flush();
+                auto end = std::chrono::high_resolution_clock::now();
+                duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+            }
+            double megabytes =
+                static_cast<double>(std::filesystem::file_size(config.logFilePath)) / LoggerConstants::MEGABYTE;
+            std::cout << std::setw(16) << std::setprecision(0) << calculateThroughput(LARGE_TEST_SIZE, duration)
+                      << std::setw(10) << std::setprecision(1)
+                      << megabytes / (static_cast<double>(duration.count()) / 1e6);
+            // Drop the dirty pages now rather than leave their writeback to later benchmarks
+            std::filesystem::remove(config.logFilePath);
+        }
+        std::cout << std::endl;
+    }
 }
 
 // ==================== BENCHMARK COMPARISON ====================
@@ -475,4 +577,1225 @@ TEST_F(PerformanceTest, PerformanceRegressionTest) {
         EXPECT_GE(performanceRatio, REGRESSION_THRESHOLD) 
             << "Performance regression detected in iteration " << iteration;
     }
-} 
\ No newline at end of file
+} 
+
+// ==================== SHUTDOWN PERFORMANCE ====================
+
+TEST_F(PerformanceTest, ShutdownTimeVsQueueDepth) {
+    const std::chrono::milliseconds deadline(20);
+    const int depths[] = {SMALL_TEST_SIZE, MEDIUM_TEST_SIZE, LARGE_TEST_SIZE};
+    const std::string padding(128, 'S');
+    
+    std::cout << "\n=== SHUTDOWN TIME VS QUEUE DEPTH ===" << std::endl;
+    std::cout << "Deadline: " << deadline.count() << " ms" << std::endl;
+    
+    for (int depth : depths) {
+        Logger::Config config = perfConfig;
+        config.asyncEngine = Logger::AsyncEngine::LANES;
+        config.queueSize = static_cast<size_t>(depth);
+        
+        // Unbounded drain (what the destructor used to do)
+        config.logFilePath = testDir + "/shutdown_full_" + std::to_string(depth) + ".log";
+        std::chrono::microseconds fullDuration;
+        {
+            Logger logger(config);
+            for (int i = 0; i < depth; ++i) {
+                logger.info("Shutdown test message " + std::to_string(i) + " " + padding);
+            }
+            fullDuration = measureTime([&]() {
+                logger.shutdown(std::chrono::milliseconds::max());
+            });
+        }
+        
+        // Bounded drain
+        config.logFilePath = testDir + "/shutdown_bounded_" + std::to_string(depth) + ".log";
+        size_t abandoned = 0;
+        std::chrono::microseconds boundedDuration;
+        {
+            Logger logger(config);
+            for (int i = 0; i < depth; ++i) {
+                logger.info("Shutdown test message " + std::to_string(i) + " " + padding);
+            }
+            boundedDuration = measureTime([&]() {
+                abandoned = logger.shutdown(deadline);
+            });
+        }
+        
+        std::ifstream file(config.logFilePath);
+        std::string line;
+        size_t written = 0;
+        while (std::getline(file, line)) {
+            if (line.find("Shutdown test message") != std::string::npos) {
+                ++written;
+            }
+        }
+        
+        std::cout << "Depth " << depth << ": full drain " << fullDuration.count() << " μs, "
+                  << "bounded " << boundedDuration.count() << " μs, "
+                  << "abandoned " << abandoned << std::endl;
+        
+        EXPECT_EQ(written + abandoned, static_cast<size_t>(depth)) << "Every record is either written or reported";
+        EXPECT_LT(boundedDuration.count(), 500000) << "Bounded shutdown should finish close to its deadline";
+        
+        // Deleting the files drops their dirty pages, so no writeback from
+        // this benchmark is left to slow down whichever test runs next
+        file.close();
+        std::filesystem::remove(testDir + "/shutdown_full_" + std::to_string(depth) + ".log");
+        std::filesystem::remove(config.logFilePath);
+    }
+    ::sync();
+}
+
+// ==================== THREAD SCALING ====================
+
+TEST_F(PerformanceTest, ThreadScalingCurves) {
+    const int producerCounts[] = {1, 2, 4, 8, 16, 32, 64};
+    const int messagesPerPoint = 64000;
+    const std::pair<const char*, Logger::AsyncEngine> engines[] = {
+        {"THREAD_POOL", Logger::AsyncEngine::THREAD_POOL},
+        {"LANES", Logger::AsyncEngine::LANES},
+        {"LOCK_FREE", Logger::AsyncEngine::LOCK_FREE},
+    };
+    
+    std::cout << "\n=== THREAD SCALING CURVES (enqueue msg/sec) ===" << std::endl;
+    std::cout << std::setw(10) << "Producers";
+    for (const auto& engine : engines) {
+        std::cout << std::setw(16) << engine.first;
+    }
+    std::cout << std::endl;
+    
+    for (int producers : producerCounts) {
+        std::cout << std::setw(10) << producers;
+        for (const auto& engine : engines) {
+            Logger::Config config = perfConfig;
+            config.asyncEngine = engine.second;
+            config.logFilePath = testDir + "/scaling_" + engine.first + ".log";
+            Logger logger(config);
+            
+            std::atomic<int> messageCount{0};
+            std::vector<std::thread> threads;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int t = 0; t < producers; ++t) {
+                threads.emplace_back([&, t]() {
+                    for (int i = 0; i < messagesPerPoint / producers; ++i) {
+                        logger.info("Scaling thread " + std::to_string(t) + " message " + std::to_string(i));
+                        messageCount++;
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - start);
+            logger.flush();
+            
+            std::cout << std::setw(16) << std::fixed << std::setprecision(0)
+                      << calculateThroughput(messageCount.load(), duration);
+            
+            EXPECT_EQ(messageCount.load(), (messagesPerPoint / producers) * producers);
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Shard count against the MultiThreadedThroughput workload
+TEST_F(PerformanceTest, ShardCountThroughput) {
+    const size_t shardCounts[] = {1, 2, 4, 8};
+    
+    auto run = [&](const Logger::Config& config) {
+        Logger logger(config);
+        std::atomic<int> messageCount{0};
+        std::vector<std::thread> threads;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < THREAD_COUNT; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < LARGE_TEST_SIZE / THREAD_COUNT; ++i) {
+                    logger.info("Thread " + std::to_string(t) + " - Message " + std::to_string(i));
+                    messageCount++;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.flush();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start);
+        EXPECT_EQ(messageCount.load(), LARGE_TEST_SIZE);
+        return calculateThroughput(messageCount.load(), duration);
+    };
+    
+    std::cout << "\n=== SHARD COUNT THROUGHPUT (" << THREAD_COUNT << " threads) ===" << std::endl;
+    Logger::Config baseline = perfConfig;
+    baseline.logFilePath = testDir + "/shards_thread_pool.log";
+    std::cout << std::setw(22) << "THREAD_POOL" << std::setw(16) << std::fixed << std::setprecision(0)
+              << run(baseline) << " msg/sec" << std::endl;
+    
+    for (size_t workers : {size_t{1}, size_t{2}}) {
+        for (size_t shards : shardCounts) {
+            if (workers > shards) {
+                continue;
+            }
+            Logger::Config config = perfConfig;
+            config.asyncEngine = Logger::AsyncEngine::LANES;
+            config.queueShards = shards;
+            config.backendWorkers = workers;
+            config.logFilePath = testDir + "/shards_" + std::to_string(shards) + "_" + std::to_string(workers) + ".log";
+            std::string label = "LANES K=" + std::to_string(shards) + " W=" + std::to_string(workers);
+            std::cout << std::setw(22) << label << std::setw(16) << std::fixed << std::setprecision(0)
+                      << run(config) << " msg/sec" << std::endl;
+        }
+    }
+}
+
+// Producers pinned to each NUMA node, spdlog thread pool vs. node-local queues
+TEST_F(PerformanceTest, NumaNodeThroughput) {
+    const auto& topology = LoggerDetail::NumaTopology::system();
+    const int messagesPerNode = 40000;
+    
+    auto run = [&](const Logger::Config& config, size_t node) {
+        Logger logger(config);
+        int producers = static_cast<int>(std::min<size_t>(4, topology.nodes[node].cpus.size()));
+        std::atomic<int> messageCount{0};
+        std::vector<std::thread> threads;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < producers; ++t) {
+            threads.emplace_back([&, t]() {
+                topology.pinToNode(node);
+                for (int i = 0; i < messagesPerNode / producers; ++i) {
+                    logger.info("Node " + std::to_string(node) + " thread " + std::to_string(t) +
+                                " message " + std::to_string(i));
+                    messageCount++;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.flush();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start);
+        EXPECT_EQ(messageCount.load(), (messagesPerNode / producers) * producers);
+        return calculateThroughput(messageCount.load(), duration);
+    };
+    
+    std::cout << "\n=== NUMA NODE THROUGHPUT ===" << std::endl;
+    std::cout << "Nodes: " << topology.nodes.size()
+              << (topology.detected ? " (sysfs)" : " (no topology, single node assumed)") << std::endl;
+    std::cout << std::setw(6) << "Node" << std::setw(8) << "CPUs"
+              << std::setw(16) << "THREAD_POOL" << std::setw(16) << "NUMA" << std::endl;
+    
+    for (size_t node = 0; node < topology.nodes.size(); ++node) {
+        Logger::Config baseline = perfConfig;
+        baseline.logFilePath = testDir + "/numa_thread_pool.log";
+        
+        Logger::Config numa = perfConfig;
+        numa.asyncEngine = Logger::AsyncEngine::LANES;
+        numa.numaAware = true;
+        numa.logFilePath = testDir + "/numa_engine.log";
+        
+        std::cout << std::setw(6) << topology.nodes[node].id
+                  << std::setw(8) << topology.nodes[node].cpus.size()
+                  << std::setw(16) << std::fixed << std::setprecision(0) << run(baseline, node)
+                  << std::setw(16) << run(numa, node) << std::endl;
+    }
+}
+
+// Peak RSS of a full queue as message size grows: slot-counted vs byte-bounded
+TEST_F(PerformanceTest, PeakRssVsMessageSize) {
+    const size_t messageSizes[] = {64, 256, 1024, 4096};
+    const int messagesPerRun = 20000;
+    
+    auto readStatusKb = [](const std::string& key) -> size_t {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, key.size(), key) == 0) {
+                size_t pos = line.find_first_of("0123456789");
+                if (pos != std::string::npos) {
+                    return std::stoul(line.substr(pos));
+                }
+            }
+        }
+        return 0;
+    };
+    
+    bool peakResettable = true;
+    auto run = [&](const Logger::Config& config, size_t messageSize) {
+        // Writing 5 to clear_refs resets VmHWM to the current RSS
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5" << std::flush;
+        peakResettable = peakResettable && clearRefs.good();
+        size_t before = readStatusKb("VmRSS:");
+        {
+            Logger logger(config);
+            std::string message(messageSize, 'm');
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 2; ++t) {
+                threads.emplace_back([&]() {
+                    for (int i = 0; i < messagesPerRun / 2; ++i) {
+                        logger.info(message);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            logger.flush();
+        }
+        size_t peak = readStatusKb("VmHWM:");
+        return peak > before ? peak - before : 0;
+    };
+    
+    Logger::Config slots = perfConfig;
+    slots.asyncEngine = Logger::AsyncEngine::LANES;
+    slots.queueSize = 8192;
+    slots.logFilePath = testDir + "/rss_slots.log";
+    
+    Logger::Config bytes = perfConfig;
+    bytes.asyncEngine = Logger::AsyncEngine::BYTE_RING;
+    bytes.queueBytes = 8 * LoggerConstants::MEGABYTE;
+    bytes.logFilePath = testDir + "/rss_bytes.log";
+    
+    std::cout << "\n=== PEAK RSS VS MESSAGE SIZE (KB above baseline) ===" << std::endl;
+    std::cout << std::setw(10) << "Msg bytes" << std::setw(22) << "LANES 8192 slots"
+              << std::setw(22) << "BYTE_RING 8 MB" << std::endl;
+    for (size_t size : messageSizes) {
+        size_t slotPeak = run(slots, size);
+        size_t bytePeak = run(bytes, size);
+        std::cout << std::setw(10) << size << std::setw(22) << slotPeak << std::setw(22) << bytePeak << std::endl;
+        
+        // Ring, priority lane and one in-flight copy, with slack for the sink and allocator
+        EXPECT_LT(bytePeak, (bytes.queueBytes + bytes.queueBytes / 16) / 1024 + 8 * 1024)
+            << "BYTE_RING must stay within its byte budget";
+    }
+    if (!peakResettable) {
+        std::cout << "(/proc/self/clear_refs not writable: peaks are cumulative)" << std::endl;
+    }
+}
+
+// Enqueue cost and dTLB misses of large queues on regular vs. huge pages
+TEST_F(PerformanceTest, HugePageEnqueueCost) {
+    using LoggerDetail::PageMode;
+    const size_t slotCount = 500000;                 // Mirrors a queueSize = 500000 deployment
+    const size_t ringBytes = 128 * LoggerConstants::MEGABYTE;
+    const int rounds = 4;
+    
+    // dTLB load + store misses of the calling thread, when perf_event_open is permitted
+    struct DtlbCounter {
+        std::vector<int> fds;
+        DtlbCounter() {
+            for (uint64_t op : {uint64_t{PERF_COUNT_HW_CACHE_OP_READ}, uint64_t{PERF_COUNT_HW_CACHE_OP_WRITE}}) {
+                perf_event_attr attr{};
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_DTLB | (op << 8) | (uint64_t{PERF_COUNT_HW_CACHE_RESULT_MISS} << 16);
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+                if (fd >= 0) {
+                    fds.push_back(fd);
+                }
+            }
+        }
+        ~DtlbCounter() {
+            for (int fd : fds) {
+                close(fd);
+            }
+        }
+        bool available() const { return !fds.empty(); }
+        void start() {
+            for (int fd : fds) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+        uint64_t stop() {
+            uint64_t total = 0;
+            for (int fd : fds) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                uint64_t count = 0;
+                if (read(fd, &count, sizeof(count)) == sizeof(count)) {
+                    total += count;
+                }
+            }
+            return total;
+        }
+    };
+    
+    const std::string payload(128, 'p');
+    spdlog::details::log_msg msg(spdlog::source_loc{}, "bench", spdlog::level::info, payload);
+    
+    // Fill the queue three quarters full, drain it, repeat; only the pushes are timed
+    auto measure = [&](LoggerDetail::RecordQueue& queue, size_t perRound, double& nsPerEnqueue, uint64_t& misses) {
+        DtlbCounter counter;
+        LoggerDetail::QueuedRecord out;
+        std::chrono::nanoseconds pushTime{0};
+        uint64_t missTotal = 0;
+        size_t pushes = 0;
+        for (int round = 0; round < rounds; ++round) {
+            counter.start();
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < perRound; ++i) {
+                bool pushed = queue.storesMessages() ? queue.tryPushMessage(msg)
+                                                     : queue.tryPush(LoggerDetail::QueuedRecord(msg));
+                pushes += pushed ? 1 : 0;
+            }
+            pushTime += std::chrono::high_resolution_clock::now() - start;
+            missTotal += counter.stop();
+            while (queue.tryPop(out)) {
+            }
+        }
+        nsPerEnqueue = static_cast<double>(pushTime.count()) / static_cast<double>(std::max<size_t>(pushes, 1));
+        misses = counter.available() ? missTotal : UINT64_MAX;
+    };
+    
+    auto modeName = [](PageMode mode) {
+        switch (mode) {
+            case PageMode::TRANSPARENT_HUGE: return "transparent";
+            case PageMode::EXPLICIT_HUGE:    return "explicit";
+            default:                         return "regular";
+        }
+    };
+    
+    std::cout << "\n=== HUGE PAGE ENQUEUE COST ===" << std::endl;
+    std::cout << std::setw(12) << "Queue" << std::setw(14) << "Requested" << std::setw(14) << "Ring got"
+              << std::setw(14) << "ns/enqueue" << std::setw(16) << "dTLB misses" << std::endl;
+    
+    for (PageMode mode : {PageMode::NORMAL, PageMode::TRANSPARENT_HUGE, PageMode::EXPLICIT_HUGE}) {
+        double ns = 0;
+        uint64_t misses = 0;
+        {
+            LoggerDetail::RingQueue slots(slotCount, true, mode);
+            measure(slots, slotCount * 3 / 4, ns, misses);
+        }
+        std::cout << std::setw(12) << "RingQueue" << std::setw(14) << modeName(mode) << std::setw(14) << "-"
+                  << std::setw(14) << std::fixed << std::setprecision(1) << ns << std::setw(16)
+                  << (misses == UINT64_MAX ? std::string("n/a") : std::to_string(misses)) << std::endl;
+        
+        {
+            LoggerDetail::ByteRingQueue ring(ringBytes, true, mode);
+            size_t recordBytes = 64 + payload.size() + 8; // Header, name and payload, roughly
+            measure(ring, ringBytes / recordBytes * 3 / 4, ns, misses);
+            std::cout << std::setw(12) << "ByteRing" << std::setw(14) << modeName(mode)
+                      << std::setw(14) << modeName(ring.pageMode())
+                      << std::setw(14) << std::fixed << std::setprecision(1) << ns << std::setw(16)
+                      << (misses == UINT64_MAX ? std::string("n/a") : std::to_string(misses)) << std::endl;
+        }
+        EXPECT_GT(ns, 0.0);
+    }
+}
+
+// Allocator time per queued payload and heap fragmentation, malloc vs. per-thread slabs
+TEST_F(PerformanceTest, SlabAllocatorCost) {
+    const int batches = 200;
+    const int batchSize = 1000;
+    
+    auto sizes = [](int count) {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<size_t> dist(256, 4096);
+        std::vector<size_t> result(static_cast<size_t>(count));
+        for (auto& size : result) {
+            size = dist(gen);
+        }
+        return result;
+    };
+    const auto payloadSizes = sizes(batchSize);
+    const std::string source(4096, 's');
+    
+    // Producer builds records, another thread frees them, as the backend worker would
+    auto allocatorNs = [&](bool slab) {
+        std::chrono::nanoseconds total{0};
+        for (int b = 0; b < batches; ++b) {
+            std::vector<LoggerDetail::QueuedRecord> batch;
+            batch.reserve(static_cast<size_t>(batchSize));
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t size : payloadSizes) {
+                spdlog::details::log_msg msg(spdlog::source_loc{}, "bench", spdlog::level::info,
+                                             spdlog::string_view_t(source.data(), size));
+                if (slab) {
+                    batch.emplace_back(msg, LoggerDetail::PayloadSlab::local());
+                } else {
+                    batch.emplace_back(msg);
+                }
+            }
+            total += std::chrono::high_resolution_clock::now() - start;
+            std::thread([records = std::move(batch)]() mutable { records.clear(); }).join();
+        }
+        return static_cast<double>(total.count()) / (batches * batchSize);
+    };
+    
+    // Long mixed run in a child process so each mode starts from a fresh heap
+    struct HeapReport {
+        size_t arena;
+        size_t inUse;
+        size_t free;
+        size_t slabMapped;
+    };
+    auto longRun = [&](bool slab) {
+        HeapReport report{};
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return report;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            {
+                Logger::Config config = perfConfig;
+                config.asyncEngine = Logger::AsyncEngine::LANES;
+                config.slabAllocator = slab;
+                config.logFilePath = testDir + (slab ? "/slab_on.log" : "/slab_off.log");
+                Logger logger(config);
+                std::vector<std::thread> threads;
+                for (int t = 0; t < 4; ++t) {
+                    threads.emplace_back([&, t]() {
+                        std::mt19937 gen(static_cast<unsigned>(t));
+                        std::uniform_int_distribution<size_t> messageSize(256, 4096);
+                        std::uniform_int_distribution<size_t> appSize(64, 8192);
+                        std::vector<std::string> appData(256);
+                        for (int i = 0; i < 50000; ++i) {
+                            logger.info(std::string(messageSize(gen), 'm'));
+                            appData[static_cast<size_t>(i) % appData.size()] = std::string(appSize(gen), 'a');
+                        }
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+                logger.flush();
+                struct mallinfo2 info = mallinfo2();
+                HeapReport child{info.arena, info.uordblks, info.fordblks, LoggerDetail::PayloadSlab::mappedBytes()};
+                ssize_t written = write(fds[1], &child, sizeof(child));
+                (void)written;
+            }
+            _exit(0);
+        }
+        close(fds[1]);
+        if (read(fds[0], &report, sizeof(report)) != static_cast<ssize_t>(sizeof(report))) {
+            report = HeapReport{};
+        }
+        close(fds[0]);
+        waitpid(pid, nullptr, 0);
+        return report;
+    };
+    
+    std::cout << "\n=== SLAB ALLOCATOR COST ===" << std::endl;
+    std::cout << std::setw(8) << "Mode" << std::setw(14) << "ns/message" << std::setw(14) << "Heap KB"
+              << std::setw(14) << "Heap free KB" << std::setw(16) << "Fragmentation" << std::setw(14) << "Slab KB"
+              << std::endl;
+    for (bool slab : {false, true}) {
+        double ns = allocatorNs(slab);
+        HeapReport heap = longRun(slab);
+        double fragmentation = heap.arena > 0 ? 100.0 * static_cast<double>(heap.free) / static_cast<double>(heap.arena) : 0.0;
+        std::cout << std::setw(8) << (slab ? "slab" : "malloc") << std::setw(14) << std::fixed << std::setprecision(1)
+                  << ns << std::setw(14) << heap.arena / 1024 << std::setw(14) << heap.free / 1024
+                  << std::setw(15) << fragmentation << "%" << std::setw(14) << heap.slabMapped / 1024 << std::endl;
+        EXPECT_GT(heap.arena, 0U) << "Child run should report heap statistics";
+    }
+}
+
+// Bursty load on fixed small, fixed large and auto-tuned LANES queues
+TEST_F(PerformanceTest, AutoTuneQueueSizing) {
+    const int bursts = 8;
+    const int burstMessages = 40000;
+    const auto gap = std::chrono::milliseconds(200);
+    
+    struct Result {
+        double burstNsPerMessage;
+        Logger::QueueStats stats;
+    };
+    auto run = [&](const Logger::Config& config) {
+        Result result{};
+        Logger logger(config);
+        std::chrono::nanoseconds producing{0};
+        for (int b = 0; b < bursts; ++b) {
+            std::vector<std::thread> threads;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int t = 0; t < THREAD_COUNT; ++t) {
+                threads.emplace_back([&, t]() {
+                    for (int i = 0; i < burstMessages / THREAD_COUNT; ++i) {
+                        logger.info("Burst " + std::to_string(b) + " thread " + std::to_string(t) + " message " +
+                                    std::to_string(i));
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            producing += std::chrono::high_resolution_clock::now() - start;
+            std::this_thread::sleep_for(gap);
+        }
+        result.burstNsPerMessage = static_cast<double>(producing.count()) / (bursts * burstMessages);
+        result.stats = logger.queueStats();
+        return result;
+    };
+    
+    std::cout << "\n=== AUTO-TUNED QUEUE SIZING (" << THREAD_COUNT << " threads, " << bursts << " bursts of "
+              << burstMessages << ") ===" << std::endl;
+    std::cout << std::setw(12) << "Queue" << std::setw(14) << "Burst ns/msg" << std::setw(12) << "Slots"
+              << std::setw(14) << "Slot KB" << std::setw(12) << "Blocked" << std::setw(10) << "Resizes"
+              << std::setw(14) << "Recommended" << std::endl;
+    struct Variant {
+        const char* label;
+        size_t queueSize;
+        bool autoTune;
+    };
+    for (const Variant& variant : {Variant{"1024", 1024, false}, Variant{"131072", 131072, false},
+                                   Variant{"auto", 1024, true}}) {
+        Logger::Config config = perfConfig;
+        config.asyncEngine = Logger::AsyncEngine::LANES;
+        config.queueSize = variant.queueSize;
+        config.autoTuneQueue = variant.autoTune;
+        config.logFilePath = testDir + "/auto_tune_" + variant.label + ".log";
+        Result result = run(config);
+        std::cout << std::setw(12) << variant.label << std::setw(14) << std::fixed << std::setprecision(1)
+                  << result.burstNsPerMessage << std::setw(12) << result.stats.capacity << std::setw(14)
+                  << result.stats.capacity * sizeof(LoggerDetail::QueuedRecord) / 1024;
+        if (variant.autoTune) {
+            std::cout << std::setw(12) << result.stats.blockedPushes << std::setw(10) << result.stats.resizes
+                      << std::setw(14) << result.stats.recommendedQueueSize << std::endl;
+            std::cout << "  arrival rate per shard: median " << std::setprecision(0) << result.stats.arrivalRateMedian
+                      << ", p99 " << result.stats.arrivalRateP99 << ", peak " << result.stats.arrivalRatePeak
+                      << " msg/sec; high-water mark " << result.stats.highWaterMark << std::endl;
+            EXPECT_GT(result.stats.highWaterMark, 0U);
+        } else {
+            std::cout << std::setw(12) << "-" << std::setw(10) << "-" << std::setw(14) << "-" << std::endl;
+        }
+    }
+}
+
+// MultiThreadedThroughput with lines grouped by Logger::batch() vs. one call per line
+TEST_F(PerformanceTest, MultiThreadedBatchThroughput) {
+    auto run = [&](const Logger::Config& config, int linesPerBatch) {
+        Logger logger(config);
+        std::atomic<int> messageCount{0};
+        std::vector<std::thread> threads;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < THREAD_COUNT; ++t) {
+            threads.emplace_back([&, t]() {
+                const int iterations = LARGE_TEST_SIZE / THREAD_COUNT / std::max(linesPerBatch, 1);
+                for (int i = 0; i < iterations; ++i) {
+                    if (linesPerBatch == 0) {
+                        logger.info("Thread " + std::to_string(t) + " - Message " + std::to_string(i));
+                        messageCount++;
+                        continue;
+                    }
+                    auto batch = logger.batch();
+                    for (int l = 0; l < linesPerBatch; ++l) {
+                        batch.info("Thread " + std::to_string(t) + " - Message " + std::to_string(i) + "." +
+                                   std::to_string(l));
+                    }
+                    messageCount += linesPerBatch;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto produced = std::chrono::high_resolution_clock::now();
+        logger.flush();
+        auto end = std::chrono::high_resolution_clock::now();
+        EXPECT_EQ(messageCount.load(), LARGE_TEST_SIZE);
+        return std::make_pair(
+            calculateThroughput(messageCount.load(), std::chrono::duration_cast<std::chrono::microseconds>(end - start)),
+            static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(produced - start).count()) *
+                THREAD_COUNT / messageCount.load());
+    };
+    
+    std::cout << "\n=== MULTI-THREADED BATCH THROUGHPUT (" << THREAD_COUNT << " threads) ===" << std::endl;
+    std::cout << std::setw(12) << "Engine" << std::setw(22) << "Per line" << std::setw(22) << "Batch of 10"
+              << std::setw(22) << "Batch of 50" << std::endl;
+    std::cout << std::setw(12) << "" << std::setw(22) << "msg/sec  ns/line" << std::setw(22) << "msg/sec  ns/line"
+              << std::setw(22) << "msg/sec  ns/line" << std::endl;
+    const std::pair<const char*, Logger::AsyncEngine> engines[] = {
+        {"LANES", Logger::AsyncEngine::LANES},
+        {"LOCK_FREE", Logger::AsyncEngine::LOCK_FREE},
+        {"BYTE_RING", Logger::AsyncEngine::BYTE_RING},
+    };
+    for (const auto& engine : engines) {
+        std::cout << std::setw(12) << engine.first;
+        for (int linesPerBatch : {0, 10, 50}) {
+            Logger::Config config = perfConfig;
+            config.asyncEngine = engine.second;
+            config.logFilePath = testDir + "/batch_" + engine.first + "_" + std::to_string(linesPerBatch) + ".log";
+            auto result = run(config, linesPerBatch);
+            std::cout << std::setw(13) << std::fixed << std::setprecision(0) << result.first << std::setw(9)
+                      << result.second;
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Relay forwarding preformatted lines: info() per line vs. logLines() per received chunk
+TEST_F(PerformanceTest, BulkIngestionThroughput) {
+    std::vector<std::string> lines;
+    lines.reserve(LARGE_TEST_SIZE);
+    for (int i = 0; i < LARGE_TEST_SIZE; ++i) {
+        lines.push_back("[worker-" + std::to_string(i % 16) + "] request " + std::to_string(i) +
+                        " handled in " + std::to_string(i % 997) + " us");
+    }
+    
+    // Producer time per line, and end-to-end throughput including the final flush
+    auto run = [&](const Logger::Config& config, size_t chunk) {
+        Logger logger(config);
+        auto start = std::chrono::high_resolution_clock::now();
+        if (chunk == 0) {
+            for (const auto& line : lines) {
+                logger.info(line);
+            }
+        } else {
+            for (size_t offset = 0; offset < lines.size(); offset += chunk) {
+                auto first = lines.begin() + static_cast<std::ptrdiff_t>(offset);
+                auto last = lines.begin() + static_cast<std::ptrdiff_t>(std::min(offset + chunk, lines.size()));
+                logger.logLines(Logger::LogLevel::INFO, first, last);
+            }
+        }
+        auto produced = std::chrono::high_resolution_clock::now();
+        logger.flush();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::make_pair(
+            static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(produced - start).count()) /
+                LARGE_TEST_SIZE,
+            calculateThroughput(LARGE_TEST_SIZE, std::chrono::duration_cast<std::chrono::microseconds>(end - start)));
+    };
+    
+    std::cout << "\n=== BULK INGESTION THROUGHPUT (" << LARGE_TEST_SIZE << " preformatted lines) ===" << std::endl;
+    std::cout << std::setw(12) << "Engine" << std::setw(22) << "info() per line" << std::setw(22)
+              << "logLines() x64" << std::setw(22) << "logLines() x1024" << std::endl;
+    std::cout << std::setw(12) << "" << std::setw(22) << "ns/line  msg/sec" << std::setw(22) << "ns/line  msg/sec"
+              << std::setw(22) << "ns/line  msg/sec" << std::endl;
+    const std::pair<const char*, Logger::AsyncEngine> engines[] = {
+        {"LANES", Logger::AsyncEngine::LANES},
+        {"LOCK_FREE", Logger::AsyncEngine::LOCK_FREE},
+        {"BYTE_RING", Logger::AsyncEngine::BYTE_RING},
+    };
+    for (const auto& engine : engines) {
+        std::cout << std::setw(12) << engine.first;
+        for (size_t chunk : {size_t{0}, size_t{64}, size_t{1024}}) {
+            Logger::Config config = perfConfig;
+            config.asyncEngine = engine.second;
+            config.queueBytes = 64 * LoggerConstants::MEGABYTE;
+            config.logFilePath = testDir + "/bulk_" + engine.first + "_" + std::to_string(chunk) + ".log";
+            auto result = run(config, chunk);
+            std::cout << std::setw(10) << std::fixed << std::setprecision(1) << result.first << std::setw(12)
+                      << std::setprecision(0) << result.second;
+        }
+        std::cout << std::endl;
+    }
+}
+
+TEST_F(PerformanceTest, ManualPumpEventLoop) {
+    // A single-threaded event loop: handle a tick of events, logging each, then
+    // let the logger write. THREAD_POOL and LANES write on their own thread.
+    constexpr int TICK = 64;
+    auto run = [&](const Logger::Config& config) {
+        Logger logger(config);
+        rusage before{};
+        getrusage(RUSAGE_SELF, &before);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < LARGE_TEST_SIZE; ++i) {
+            logger.info("event " + std::to_string(i) + " handled on fd " + std::to_string(i % 97));
+            if (config.manualPump && (i + 1) % TICK == 0) {
+                logger.poll();
+            }
+        }
+        logger.flush();
+        auto end = std::chrono::high_resolution_clock::now();
+        rusage after{};
+        getrusage(RUSAGE_SELF, &after);
+        return std::make_tuple(std::chrono::duration_cast<std::chrono::microseconds>(end - start),
+                               after.ru_nvcsw - before.ru_nvcsw, after.ru_nivcsw - before.ru_nivcsw);
+    };
+    
+    std::cout << "\n=== MANUAL PUMP EVENT LOOP (" << LARGE_TEST_SIZE << " events, poll() every " << TICK
+              << ") ===" << std::endl;
+    std::cout << std::setw(14) << "Mode" << std::setw(14) << "ns/event" << std::setw(14) << "msg/sec" << std::setw(14)
+              << "voluntary" << std::setw(14) << "involuntary" << std::endl;
+    struct Mode {
+        const char* name;
+        Logger::AsyncEngine engine;
+        bool manual;
+    };
+    for (const Mode& mode : {Mode{"THREAD_POOL", Logger::AsyncEngine::THREAD_POOL, false},
+                             Mode{"LANES", Logger::AsyncEngine::LANES, false},
+                             Mode{"MANUAL", Logger::AsyncEngine::LANES, true}}) {
+        Logger::Config config = perfConfig;
+        config.asyncEngine = mode.engine;
+        config.manualPump = mode.manual;
+        config.logFilePath = testDir + "/pump_" + mode.name + ".log";
+        auto [elapsed, voluntary, involuntary] = run(config);
+        std::cout << std::setw(14) << mode.name << std::setw(14) << std::fixed << std::setprecision(1)
+                  << static_cast<double>(elapsed.count()) * 1000.0 / LARGE_TEST_SIZE << std::setw(14)
+                  << std::setprecision(0) << calculateThroughput(LARGE_TEST_SIZE, elapsed) << std::setw(14)
+                  << voluntary << std::setw(14) << involuntary << std::endl;
+        EXPECT_GT(elapsed.count(), 0);
+    }
+}
+
+// ==================== ROTATION LATENCY ====================
+
+TEST_F(PerformanceTest, RotationWorstCaseLatency) {
+    std::cout << "\n=== WORST-CASE LATENCY DURING ROTATION ===" << std::endl;
+    // Synchronous logging, so each call's time includes the rotations it triggers;
+    // small files and many of them make every rotation a long rename cascade
+    const int messages = LARGE_TEST_SIZE;
+    const std::string payload(200, 'R');
+    std::cout << "Messages: " << messages << ", 256KB files, up to 100 kept" << std::endl;
+    std::cout << std::setw(12) << "Backend" << std::setw(10) << "Rotation" << std::setw(10) << "p50 ns"
+              << std::setw(12) << "p99.9 ns" << std::setw(12) << "max μs" << std::setw(14) << "msg/sec" << std::endl;
+    
+    const std::pair<const char*, Logger::FileBackend> backends[] = {
+        {"STDIO", Logger::FileBackend::STDIO},
+        {"MMAP", Logger::FileBackend::MMAP},
+        {"DIRECT", Logger::FileBackend::DIRECT},
+    };
+    for (const auto& backend : backends) {
+        for (bool asyncRotation : {false, true}) {
+            std::filesystem::remove_all(testDir);
+            std::filesystem::create_directories(testDir);
+            Logger::Config config = perfConfig;
+            config.asyncLogging = false;
+            config.fileBackend = backend.second;
+            config.asyncRotation = asyncRotation;
+            config.maxFileSize = 256 * 1024;
+            config.maxFiles = 100;
+            config.logFilePath = testDir + "/latency.log";
+            
+            std::vector<int64_t> latencies(messages);
+            std::chrono::microseconds duration{};
+            {
+                Logger logger(config);
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < messages; ++i) {
+                    auto before = std::chrono::steady_clock::now();
+                    logger.info(payload);
+                    latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - before).count();
+                }
+                duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+            }
+            
+            std::sort(latencies.begin(), latencies.end());
+            std::cout << std::setw(12) << backend.first << std::setw(10) << (asyncRotation ? "async" : "inline")
+                      << std::setw(10) << latencies[messages / 2]
+                      << std::setw(12) << latencies[static_cast<size_t>(messages * 0.999)]
+                      << std::setw(12) << latencies.back() / 1000
+                      << std::setw(14) << std::fixed << std::setprecision(0) << calculateThroughput(messages, duration)
+                      << std::endl;
+            
+            EXPECT_TRUE(std::filesystem::exists(testDir + "/latency.50.log")) << backend.first;
+            EXPECT_LT(duration.count(), 10000000) << "Should complete in < 10 seconds";
+        }
+    }
+}
+
+// ==================== ROTATION COST VS RETAINED FILES ====================
+
+TEST_F(PerformanceTest, RotationCostVsRetainedFiles) {
+    std::cout << "\n=== ROTATION COST VS RETAINED FILES ===" << std::endl;
+    // Every 600-byte record overflows a 1KB file, so each call is one rotation
+    // with all retained files already present
+    const int rotations = 200;
+    const std::string payload(600, 'C');
+    std::cout << std::setw(10) << "Retained" << std::setw(12) << "Naming" << std::setw(16) << "μs/rotation" << std::endl;
+    
+    for (int retained : {5, 500}) {
+        double cascade = 0;
+        for (Logger::RotationNaming naming : {Logger::RotationNaming::CASCADE, Logger::RotationNaming::SEQUENTIAL}) {
+            std::filesystem::remove_all(testDir);
+            std::filesystem::create_directories(testDir);
+            for (int i = 1; i <= retained; ++i) {
+                std::ofstream(testDir + "/cost." + std::to_string(i) + ".log") << "retained\n";
+            }
+            Logger::Config config = perfConfig;
+            config.asyncLogging = false;
+            config.logFilePath = testDir + "/cost.log";
+            config.maxFileSize = 1024;
+            config.maxFiles = retained;
+            config.rotationNaming = naming;
+            
+            Logger logger(config);
+            logger.info(payload);
+            auto duration = measureTime([&]() {
+                for (int i = 0; i < rotations; ++i) {
+                    logger.info(payload);
+                }
+            });
+            double perRotation = static_cast<double>(duration.count()) / rotations;
+            bool sequential = (naming == Logger::RotationNaming::SEQUENTIAL);
+            std::cout << std::setw(10) << retained << std::setw(12) << (sequential ? "SEQUENTIAL" : "CASCADE")
+                      << std::setw(16) << std::fixed << std::setprecision(1) << perRotation << std::endl;
+            
+            if (!sequential) {
+                cascade = perRotation;
+            } else if (retained >= 100) {
+                EXPECT_LT(perRotation, cascade) << "One rename per rotation must beat " << retained << " renames";
+            }
+        }
+    }
+}
+
+// ==================== COMPRESSED ROTATION ====================
+
+TEST_F(PerformanceTest, CompressedRotationThroughput) {
+#ifndef FRESHLOGGER_WITH_ZLIB
+    GTEST_SKIP() << "Built without FRESHLOGGER_WITH_ZLIB";
+#else
+    std::cout << "\n=== COMPRESSED ROTATION THROUGHPUT ===" << std::endl;
+    // CPU seconds used so far by the thread named fl-compress, 0 if there is none
+    auto compressorCpu = []() {
+        for (const auto& task : std::filesystem::directory_iterator("/proc/self/task")) {
+            std::string comm;
+            std::getline(std::ifstream(task.path() / "comm"), comm);
+            if (comm != "fl-compress") {
+                continue;
+            }
+            std::string stat;
+            std::getline(std::ifstream(task.path() / "stat"), stat);
+            std::istringstream fields(stat.substr(stat.rfind(')') + 2));
+            std::string field;
+            unsigned long long utime = 0, stime = 0;
+            for (int i = 3; i <= 15 && fields >> field; ++i) {
+                if (i == 14) utime = std::stoull(field);
+                if (i == 15) stime = std::stoull(field);
+            }
+            return static_cast<double>(utime + stime) / static_cast<double>(sysconf(_SC_CLK_TCK));
+        }
+        return 0.0;
+    };
+    auto processCpu = []() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    };
+    
+    const int messages = 5 * LARGE_TEST_SIZE;
+    std::cout << "Messages: " << messages << " via LANES, 4MB files, SEQUENTIAL naming" << std::endl;
+    std::cout << std::setw(12) << "Compression" << std::setw(14) << "msg/sec" << std::setw(14) << "drained ms"
+              << std::setw(12) << "ratio" << std::setw(14) << "gzip MB/s" << std::setw(12) << "CPU share" << std::endl;
+    for (bool compress : {false, true}) {
+        std::filesystem::remove_all(testDir);
+        std::filesystem::create_directories(testDir);
+        Logger::Config config = perfConfig;
+        config.asyncEngine = Logger::AsyncEngine::LANES;
+        config.logFilePath = testDir + "/zipped.log";
+        config.maxFileSize = 4 * LoggerConstants::MEGABYTE;
+        config.maxFiles = 100;
+        config.rotationNaming = Logger::RotationNaming::SEQUENTIAL;
+        config.compressRotated = compress;
+        
+        auto countPlain = [&]() {
+            int plain = 0;
+            for (const auto& entry : std::filesystem::directory_iterator(testDir)) {
+                std::string name = entry.path().filename().string();
+                plain += (entry.path().extension() == ".log" && name != "zipped.log") ? 1 : 0;
+            }
+            return plain;
+        };
+        
+        Logger logger(config);
+        double cpuBefore = processCpu();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < messages; ++i) {
+            logger.info("Compressed rotation message " + std::to_string(i) + " user=" + std::to_string(i % 977) +
+                        " action=update status=ok latency_us=" + std::to_string(i % 313));
+        }
+        logger.flush();
+        auto logged = std::chrono::steady_clock::now();
+        // Compression drains after the burst; its thread is niced below the logging path
+        while (compress && countPlain() > 0 &&
+               std::chrono::steady_clock::now() - logged < std::chrono::seconds(60)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        auto drained = std::chrono::steady_clock::now();
+        double cpu = processCpu() - cpuBefore;
+        double gzipCpu = compressorCpu();
+        
+        uintmax_t raw = 0, stored = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(testDir)) {
+            if (entry.path().extension() != ".gz") {
+                continue;
+            }
+            // The gzip trailer ends with the uncompressed size modulo 2^32
+            std::ifstream file(entry.path(), std::ios::binary);
+            file.seekg(-4, std::ios::end);
+            unsigned char size[4] = {};
+            file.read(reinterpret_cast<char*>(size), 4);
+            raw += size[0] | (size[1] << 8) | (size[2] << 16) | (static_cast<uintmax_t>(size[3]) << 24);
+            stored += entry.file_size();
+        }
+        
+        auto loggedUs = std::chrono::duration_cast<std::chrono::microseconds>(logged - start);
+        std::cout << std::setw(12) << (compress ? "gzip" : "off") << std::setw(14) << std::fixed
+                  << std::setprecision(0) << calculateThroughput(messages, loggedUs) << std::setw(14)
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(drained - logged).count();
+        if (compress) {
+            std::cout << std::setw(12) << std::setprecision(1) << static_cast<double>(raw) / std::max<uintmax_t>(stored, 1)
+                      << std::setw(14) << static_cast<double>(raw) / LoggerConstants::MEGABYTE / std::max(gzipCpu, 0.01)
+                      << std::setw(11) << std::setprecision(0) << 100.0 * gzipCpu / std::max(cpu, 0.01) << "%";
+            EXPECT_EQ(countPlain(), 0) << "Every rotated file should be compressed";
+            EXPECT_GT(stored, 0u);
+            EXPECT_LT(stored, raw) << "Log text should compress";
+        }
+        std::cout << std::endl;
+    }
+#endif
+}
+
+// ==================== STREAMING GZIP SINK ====================
+
+TEST_F(PerformanceTest, GzipStreamVsPlainFile) {
+#ifndef FRESHLOGGER_WITH_ZLIB
+    GTEST_SKIP() << "Built without FRESHLOGGER_WITH_ZLIB";
+#else
+    std::cout << "\n=== STREAMING GZIP SINK VS PLAIN FILE ===" << std::endl;
+    const int messages = 5 * LARGE_TEST_SIZE;
+    std::cout << "Messages: " << messages << " (100MB files, so no rotation)" << std::endl;
+    std::cout << std::setw(10) << "Backend" << std::setw(8) << "Mode" << std::setw(14) << "msg/sec"
+              << std::setw(14) << "bytes" << std::setw(14) << "MB/s text" << std::endl;
+    
+    const std::pair<const char*, Logger::FileBackend> backends[] = {
+        {"STDIO", Logger::FileBackend::STDIO},
+        {"GZIP", Logger::FileBackend::GZIP},
+    };
+    uintmax_t plainBytes = 0;
+    for (bool async : {false, true}) {
+        for (const auto& backend : backends) {
+            Logger::Config config = perfConfig;
+            config.asyncLogging = async;
+            config.asyncEngine = Logger::AsyncEngine::LANES;
+            config.fileBackend = backend.second;
+            config.logFilePath = testDir + "/stream_" + backend.first + ".log";
+            std::chrono::microseconds duration{};
+            size_t text = 0;
+            {
+                Logger logger(config);
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < messages; ++i) {
+                    std::string line = "Request " + std::to_string(i) + " user=" + std::to_string(i % 977) +
+                                       " path=/api/v1/items/" + std::to_string(i % 4099) + " status=200 bytes=" +
+                                       std::to_string(i % 65536);
+                    text += line.size();
+                    logger.info(line);
+                }
+                logger.flush();
+                duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+            }
+            uintmax_t bytes = std::filesystem::file_size(config.logFilePath);
+            std::cout << std::setw(10) << backend.first << std::setw(8) << (async ? "LANES" : "sync")
+                      << std::setw(14) << std::fixed << std::setprecision(0) << calculateThroughput(messages, duration)
+                      << std::setw(14) << bytes << std::setw(14) << std::setprecision(1)
+                      << static_cast<double>(text) / LoggerConstants::MEGABYTE /
+                             (static_cast<double>(duration.count()) / 1e6)
+                      << std::endl;
+            if (backend.second == Logger::FileBackend::STDIO) {
+                plainBytes = bytes;
+            } else {
+                EXPECT_LT(bytes * 4, plainBytes) << "Log text should shrink at least 4x";
+            }
+            std::filesystem::remove(config.logFilePath);
+        }
+    }
+#endif
+}
+
+// ==================== TIME ROTATION CHECK OVERHEAD ====================
+
+TEST_F(PerformanceTest, TimeRotationCheckOverhead) {
+    std::cout << "\n=== TIME ROTATION CHECK OVERHEAD ===" << std::endl;
+    // Same FileSink in every row (SEQUENTIAL naming), no rotation during the run:
+    // the rows differ only by the per-record deadline compare
+    const int messages = 2 * LARGE_TEST_SIZE;
+    const int rounds = 5;
+    std::cout << "Messages: " << messages << " synchronous, best of " << rounds << std::endl;
+    std::cout << std::setw(10) << "Interval" << std::setw(14) << "ns/msg" << std::setw(14) << "msg/sec" << std::endl;
+    
+    const std::pair<const char*, Logger::RotationInterval> intervals[] = {
+        {"NONE", Logger::RotationInterval::NONE},
+        {"HOURLY", Logger::RotationInterval::HOURLY},
+        {"DAILY", Logger::RotationInterval::DAILY},
+    };
+    double baseline = 0;
+    for (const auto& interval : intervals) {
+        double best = 0;
+        for (int round = 0; round < rounds; ++round) {
+            Logger::Config config = perfConfig;
+            config.asyncLogging = false;
+            config.logFilePath = testDir + "/interval.log";
+            config.rotationNaming = Logger::RotationNaming::SEQUENTIAL;
+            config.rotationInterval = interval.second;
+            config.maxTotalSize = 10 * perfConfig.maxFileSize;
+            Logger logger(config);
+            auto duration = measureTime([&]() {
+                for (int i = 0; i < messages; ++i) {
+                    logger.info("Interval check message");
+                }
+            });
+            double ns = static_cast<double>(duration.count()) * 1000.0 / messages;
+            best = round == 0 ? ns : std::min(best, ns);
+        }
+        std::cout << std::setw(10) << interval.first << std::setw(14) << std::fixed << std::setprecision(1) << best
+                  << std::setw(14) << std::setprecision(0) << 1e9 / best << std::endl;
+        if (interval.second == Logger::RotationInterval::NONE) {
+            baseline = best;
+        } else {
+            EXPECT_LT(best, baseline * 1.5) << "The deadline compare must not add measurable per-message cost";
+        }
+        std::filesystem::remove(testDir + "/interval.log");
+    }
+}
+
+// ==================== ERROR STORM DURABILITY ====================
+
+TEST_F(PerformanceTest, ErrorStormDurability) {
+    std::cout << "\n=== ERROR STORM: DURABILITY AND GROUP COMMIT ===" << std::endl;
+    // Every record is an ERROR, so each one asks for a flush; the window lets them share it
+    const auto storm = std::chrono::seconds(1);
+    std::cout << "Producer logs ERRORs for " << storm.count() << "s (LANES), then flushes" << std::endl;
+    std::cout << std::setw(12) << "Durability" << std::setw(10) << "Window" << std::setw(14) << "msg/sec"
+              << std::setw(18) << "writes/1000 msg" << std::endl;
+    
+    auto writeSyscalls = []() -> uint64_t {
+        std::ifstream io("/proc/self/io");
+        std::string key;
+        uint64_t value = 0;
+        while (io >> key >> value) {
+            if (key == "syscw:") {
+                return value;
+            }
+        }
+        return 0;
+    };
+    
+    struct Row {
+        const char* name;
+        Logger::Durability durability;
+        int window;
+    };
+    const Row rows[] = {
+        {"NONE", Logger::Durability::NONE, 0},
+        {"FLUSH", Logger::Durability::FLUSH, 0},
+        {"FLUSH", Logger::Durability::FLUSH, 5},
+        {"FDATASYNC", Logger::Durability::FDATASYNC, 0},
+        {"FDATASYNC", Logger::Durability::FDATASYNC, 5},
+    };
+    double flushWrites = 0;
+    for (const auto& row : rows) {
+        Logger::Config config = perfConfig;
+        config.asyncLogging = true;
+        config.asyncEngine = Logger::AsyncEngine::LANES;
+        config.queueSize = 1024;
+        config.logFilePath = testDir + "/storm.log";
+        config.durability = row.durability;
+        config.groupCommitWindow = std::chrono::milliseconds(row.window);
+        uint64_t messages = 0;
+        uint64_t writes = 0;
+        std::chrono::microseconds duration{};
+        {
+            Logger logger(config);
+            uint64_t before = writeSyscalls();
+            auto start = std::chrono::steady_clock::now();
+            while (std::chrono::steady_clock::now() - start < storm) {
+                for (int i = 0; i < 64; ++i) {
+                    logger.error("Upstream timeout on request " + std::to_string(messages++));
+                }
+            }
+            logger.flush();
+            duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+            writes = writeSyscalls() - before;
+        }
+        double perThousand = 1000.0 * static_cast<double>(writes) / static_cast<double>(messages);
+        std::cout << std::setw(12) << row.name << std::setw(8) << row.window << "ms" << std::setw(14) << std::fixed
+                  << std::setprecision(0) << calculateThroughput(static_cast<int>(messages), duration)
+                  << std::setw(18) << std::setprecision(1) << perThousand << std::endl;
+        if (row.durability == Logger::Durability::FLUSH) {
+            if (row.window == 0) {
+                flushWrites = perThousand;
+            } else {
+                EXPECT_LT(perThousand, flushWrites) << "A commit window should coalesce per-ERROR flushes";
+            }
+        }
+        std::filesystem::remove(config.logFilePath);
+    }
+}
+
+// ==================== CONSOLE THROUGHPUT ====================
+
+TEST_F(PerformanceTest, ConsoleThroughputNonTty) {
+    std::cout << "\n=== CONSOLE THROUGHPUT, STDOUT NOT A TERMINAL ===" << std::endl;
+    const int messages = LARGE_TEST_SIZE;
+    const int rounds = 3;
+    std::cout << "Messages: " << messages << " synchronous, console only, best of " << rounds << std::endl;
+    std::cout << std::setw(10) << "Target" << std::setw(10) << "Mode" << std::setw(14) << "msg/sec"
+              << std::setw(10) << "Speedup" << std::endl;
+    
+    auto run = [&](Logger::ConsoleMode mode) {
+        Logger::Config config = perfConfig;
+        config.logFilePath = "";
+        config.consoleOutput = true;
+        config.asyncLogging = false;
+        config.consoleMode = mode;
+        Logger logger(config);
+        auto duration = measureTime([&]() {
+            for (int i = 0; i < messages; ++i) {
+                logger.info("Console benchmark message " + std::to_string(i));
+            }
+            logger.flush();
+        });
+        return calculateThroughput(messages, duration);
+    };
+    
+    const std::pair<const char*, Logger::ConsoleMode> modes[] = {
+        {"COLOR", Logger::ConsoleMode::COLOR},
+        {"BUFFERED", Logger::ConsoleMode::BUFFERED},
+    };
+    for (const char* target : {"/dev/null", "pipe"}) {
+        std::cout.flush();
+        fflush(stdout);
+        int savedStdout = dup(STDOUT_FILENO);
+        int pipeFds[2] = {-1, -1};
+        std::thread reader;
+        if (std::string(target) == "pipe") {
+            ASSERT_EQ(pipe(pipeFds), 0);
+            // A collector draining the pipe as fast as it can
+            reader = std::thread([fd = pipeFds[0]]() {
+                std::vector<char> chunk(64 * 1024);
+                while (read(fd, chunk.data(), chunk.size()) > 0) {
+                }
+            });
+            dup2(pipeFds[1], STDOUT_FILENO);
+        } else {
+            int devNull = open("/dev/null", O_WRONLY);
+            dup2(devNull, STDOUT_FILENO);
+            close(devNull);
+        }
+        
+        double results[2] = {0, 0};
+        for (int m = 0; m < 2; ++m) {
+            for (int round = 0; round < rounds; ++round) {
+                results[m] = std::max(results[m], run(modes[m].second));
+            }
+        }
+        
+        dup2(savedStdout, STDOUT_FILENO);
+        close(savedStdout);
+        if (reader.joinable()) {
+            close(pipeFds[1]);
+            reader.join();
+            close(pipeFds[0]);
+        }
+        for (int m = 0; m < 2; ++m) {
+            std::cout << std::setw(10) << target << std::setw(10) << modes[m].first << std::setw(14) << std::fixed
+                      << std::setprecision(0) << results[m] << std::setw(9) << std::setprecision(2)
+                      << results[m] / results[0] << "x" << std::endl;
+        }
+        EXPECT_GT(results[1], results[0]) << "Batched writes should beat a flush per record on " << target;
+    }
+}
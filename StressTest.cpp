@@ -10,6 +10,7 @@
  * - Network/filesystem stress testing
  * - Long-running stability tests
  * - Resource exhaustion tests
+ * - Page-cache footprint of the file backends
  */
 
 #include "Logger.hpp"
@@ -24,6 +25,10 @@
 #include <random>
 #include <algorithm>
 #include <filesystem>
+#include <iomanip>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 class StressTest : public ::testing::Test {
 protected:
@@ -47,7 +52,8 @@ protected:
         memoryConfig.consoleOutput = false;
         memoryConfig.asyncLogging = true;
         memoryConfig.maxFileSize = 10 * 1024 * 1024; // 10MB (increased from 1MB)
-        memoryConfig.maxFiles = 10; // Reduced from 50 to prevent rapid rotation
+        memoryConfig.maxFiles = 50;
+        memoryConfig.rotationNaming = Logger::RotationNaming::SEQUENTIAL; // Rotation cost independent of maxFiles
         memoryConfig.queueSize = 2000000;
         
         // CPU stress configuration
@@ -131,6 +137,65 @@ protected:
         return info;
     }
     
+    // Helper function to count log lines containing a given text
+    int countLinesContaining(const std::string& path, const std::string& text) {
+        std::ifstream file(path);
+        std::string line;
+        int count = 0;
+        while (std::getline(file, line)) {
+            if (line.find(text) != std::string::npos) {
+                ++count;
+            }
+        }
+        return count;
+    }
+    
+    // Helper function to measure how long an ERROR takes to become readable in
+    // the log file while a backlog of INFO records is still queued ahead of it
+    std::chrono::microseconds measureErrorToDiskLatency(Logger::Config config, int backlog) {
+        config.minLevel = Logger::LogLevel::INFO;
+        config.maxFileSize = 512 * 1024 * 1024; // No rotation while polling
+        config.maxFiles = 2;
+        config.queueSize = static_cast<size_t>(backlog) * 2;
+        
+        Logger logger(config);
+        const std::string padding(64, 'B');
+        for (int i = 0; i < backlog; ++i) {
+            logger.info("Backlog record " + std::to_string(i) + " " + padding);
+        }
+        
+        const std::string marker = "PRIORITY-MARKER-" + config.logFilePath;
+        auto start = std::chrono::high_resolution_clock::now();
+        logger.error(marker);
+        
+        std::ifstream file(config.logFilePath, std::ios::binary);
+        std::string window;
+        std::vector<char> chunk(64 * 1024);
+        auto elapsed = std::chrono::microseconds(0);
+        while (elapsed < std::chrono::seconds(30)) {
+            file.clear();
+            file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            if (file.gcount() > 0) {
+                window.append(chunk.data(), static_cast<size_t>(file.gcount()));
+                if (window.find(marker) != std::string::npos) {
+                    break;
+                }
+                if (window.size() > marker.size()) {
+                    window.erase(0, window.size() - marker.size());
+                }
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - start);
+        }
+        
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start);
+        logger.flush();
+        return latency;
+    }
+    
     Logger::Config extremeConfig;
     Logger::Config memoryConfig;
     Logger::Config cpuConfig;
@@ -142,6 +207,7 @@ protected:
     static constexpr int STABILITY_TEST_DURATION = 60;     // 1 minute (reduced from 5 minutes)
     static constexpr int MAX_THREADS = 16;
     static constexpr size_t MAX_MESSAGE_SIZE = 10000;      // 10KB messages
+    static constexpr int PRIORITY_BACKLOG = 200000;        // INFO records queued ahead of the ERROR
 };
 
 // ==================== EXTREME LOAD STRESS TEST ====================
@@ -264,6 +330,26 @@ TEST_F(StressTest, ExtremeLoadTest) {
     EXPECT_GT(successCount.load(), EXTREME_MESSAGE_COUNT * 0.99) << "99% success rate required";
     EXPECT_LT(failureCount.load(), EXTREME_MESSAGE_COUNT * 0.01) << "Failure rate should be < 1%";
     EXPECT_GT(successCount.load() / duration.count(), 10000.0) << "Should maintain > 10K msg/sec";
+    
+    // Error-to-disk latency with a deep INFO backlog: single queue vs priority lane
+    Logger::Config poolConfig = extremeConfig;
+    poolConfig.logFilePath = "stress_logs/backlog_thread_pool.log";
+    poolConfig.asyncEngine = Logger::AsyncEngine::THREAD_POOL;
+    auto poolLatency = measureErrorToDiskLatency(poolConfig, PRIORITY_BACKLOG);
+    
+    Logger::Config lanesConfig = extremeConfig;
+    lanesConfig.logFilePath = "stress_logs/backlog_lanes.log";
+    lanesConfig.asyncEngine = Logger::AsyncEngine::LANES;
+    auto lanesLatency = measureErrorToDiskLatency(lanesConfig, PRIORITY_BACKLOG);
+    
+    std::cout << "\n=== ERROR-TO-DISK LATENCY UNDER BACKLOG ===" << std::endl;
+    std::cout << "Backlog: " << PRIORITY_BACKLOG << " INFO records" << std::endl;
+    std::cout << "Thread pool queue: " << poolLatency.count() << " μs" << std::endl;
+    std::cout << "Priority lane: " << lanesLatency.count() << " μs" << std::endl;
+    
+    EXPECT_LT(lanesLatency.count(), 1000000) << "Priority lane should put the error on disk within 1 second";
+    EXPECT_EQ(countLinesContaining(lanesConfig.logFilePath, "Backlog record"), PRIORITY_BACKLOG)
+        << "Priority lane must not drop backlog records";
 }
 
 // ==================== MEMORY PRESSURE STRESS TEST ====================
@@ -608,4 +694,176 @@ TEST_F(StressTest, ResourceExhaustionTest) {
     // Check if logger gracefully handled resource constraints
     EXPECT_TRUE(successCount.load() > 0 || failureCount.load() > 0) 
         << "Logger should either succeed or fail gracefully, not hang";
-} 
\ No newline at end of file
+} 
+
+TEST_F(StressTest, MemoryReleaseAfterBurst) {
+    std::cout << "\n=== MEMORY RELEASE AFTER BURST ===" << std::endl;
+    
+    auto residentKb = []() -> size_t {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, 6, "VmRSS:") == 0) {
+                return std::stoul(line.substr(line.find_first_of("0123456789")));
+            }
+        }
+        return 0;
+    };
+    
+    // LANES keeps short records inline in its slots, so what comes back
+    // there is slot pages rather than heap
+    struct Case {
+        const char* name;
+        Logger::AsyncEngine engine;
+        size_t padding;
+    };
+    const Case cases[] = {
+        {"BYTE_RING", Logger::AsyncEngine::BYTE_RING, 512},
+        {"LANES", Logger::AsyncEngine::LANES, 128},
+    };
+    
+    for (const auto& test : cases) {
+        Logger::Config config = extremeConfig;
+        config.logFilePath = std::string("stress_logs/release_") + test.name + ".log";
+        config.asyncEngine = test.engine;
+        config.queueBytes = 128 * 1024 * 1024;
+        config.queueSize = 200000;
+        config.memoryReleaseDelay = std::chrono::milliseconds(200);
+        config.maxFileSize = 512 * 1024 * 1024; // No rotation during the burst
+        
+        Logger logger(config);
+        size_t baseline = residentKb();
+        
+        // Burst: producers outrun the file writer so the queue fills up
+        const std::string padding(test.padding, 'R');
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < 50000; ++i) {
+                    logger.info("Burst thread " + std::to_string(t) + " message " + std::to_string(i) + " " + padding);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        size_t peak = residentKb();
+        logger.flush();
+        
+        // Idle: the worker should return the queue's pages after the quiet period
+        size_t idle = peak;
+        for (int waited = 0; waited < 50; ++waited) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            idle = residentKb();
+            if (idle + (peak - baseline) / 2 < peak) {
+                break;
+            }
+        }
+        
+        std::cout << test.name << " RSS baseline: " << baseline << " KB, after burst: " << peak
+                  << " KB, after idle: " << idle << " KB" << std::endl;
+        
+        ASSERT_GT(peak, baseline + 10 * 1024) << test.name << ": burst should have grown the queue by at least 10 MB";
+        EXPECT_LT(idle, peak - (peak - baseline) / 2) << test.name << ": at least half of the burst growth should be returned";
+        
+        // Still fully usable after the release
+        logger.info("After release");
+        logger.flush();
+        EXPECT_EQ(countLinesContaining(config.logFilePath, "After release"), 1) << test.name;
+    }
+}
+
+TEST_F(StressTest, PageCacheFootprint) {
+    std::cout << "\n=== PAGE CACHE FOOTPRINT BY FILE BACKEND ===" << std::endl;
+    
+    // Pages of the file currently in the page cache
+    auto cachedKb = [](const std::string& path) -> size_t {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return 0;
+        }
+        size_t length = std::filesystem::file_size(path);
+        size_t resident = 0;
+        if (length > 0) {
+            void* map = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (map != MAP_FAILED) {
+                size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                std::vector<unsigned char> pages((length + page - 1) / page);
+                if (mincore(map, length, pages.data()) == 0) {
+                    resident = static_cast<size_t>(std::count_if(pages.begin(), pages.end(),
+                                                                 [](unsigned char p) { return p & 1; })) * page;
+                }
+                munmap(map, length);
+            }
+        }
+        ::close(fd);
+        return resident / 1024;
+    };
+    auto systemCachedKb = []() -> size_t {
+        std::ifstream meminfo("/proc/meminfo");
+        std::string line;
+        while (std::getline(meminfo, line)) {
+            if (line.compare(0, 7, "Cached:") == 0) {
+                return std::stoul(line.substr(line.find_first_of("0123456789")));
+            }
+        }
+        return 0;
+    };
+    
+    const int messages = 300000;
+    const std::string padding(200, 'P');
+    std::cout << std::setw(10) << "Backend" << std::setw(14) << "msg/sec" << std::setw(10) << "MB/s" << std::setw(16)
+              << "file cached KB" << std::setw(18) << "Cached delta KB" << std::endl;
+    const std::pair<const char*, Logger::FileBackend> backends[] = {
+        {"STDIO", Logger::FileBackend::STDIO},
+        {"DIRECT", Logger::FileBackend::DIRECT},
+        {"DONTNEED", Logger::FileBackend::DONTNEED},
+    };
+    for (const auto& backend : backends) {
+        std::filesystem::remove_all("stress_logs");
+        std::filesystem::create_directories("stress_logs");
+        Logger::Config config = extremeConfig;
+        config.asyncEngine = Logger::AsyncEngine::LANES;
+        config.fileBackend = backend.second;
+        config.logFilePath = std::string("stress_logs/cache_") + backend.first + ".log";
+        config.maxFileSize = 16 * 1024 * 1024;
+        config.maxFiles = 10;
+        
+        size_t cachedBefore = systemCachedKb();
+        auto start = std::chrono::steady_clock::now();
+        {
+            Logger logger(config);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&, t]() {
+                    for (int i = 0; i < messages / 4; ++i) {
+                        logger.info("Cache thread " + std::to_string(t) + " message " + std::to_string(i) + " " + padding);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        size_t cachedAfter = systemCachedKb();
+        
+        size_t bytes = 0;
+        size_t fileCached = 0;
+        for (const auto& entry : std::filesystem::directory_iterator("stress_logs")) {
+            bytes += entry.file_size();
+            fileCached += cachedKb(entry.path().string());
+        }
+        std::cout << std::setw(10) << backend.first << std::setw(14) << std::fixed << std::setprecision(0)
+                  << messages / seconds << std::setw(10) << std::setprecision(1)
+                  << bytes / (1024.0 * 1024.0) / seconds << std::setw(16) << fileCached << std::setw(18)
+                  << (cachedAfter > cachedBefore ? cachedAfter - cachedBefore : 0) << std::endl;
+        
+        EXPECT_GT(bytes, static_cast<size_t>(messages) * padding.size()) << backend.first;
+        if (backend.second != Logger::FileBackend::STDIO) {
+            // At most a couple of buffers' worth of the ~70 MB written may stay cached
+            EXPECT_LT(fileCached, bytes / 1024 / 4) << backend.first << " should keep the log out of the page cache";
+        }
+    }
+}
+